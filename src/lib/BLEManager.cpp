@@ -1,4 +1,7 @@
 #include "BLEManager.h"
+#include "MediaFrame.h"
+#include "MessageParser.h"
+#include "SerialLog.h"
 
 MyBLEServerCallbacks::MyBLEServerCallbacks(BLEManager *mgr) : manager(mgr)
 {
@@ -7,19 +10,13 @@ MyBLEServerCallbacks::MyBLEServerCallbacks(BLEManager *mgr) : manager(mgr)
 void MyBLEServerCallbacks::onConnect(BLEServer *pServer)
 {
   manager->setDeviceConnected(true);
-  if (manager->onConnectCallback)
-  {
-    manager->onConnectCallback();
-  }
+  manager->connectPending = true;
 }
 
 void MyBLEServerCallbacks::onDisconnect(BLEServer *pServer)
 {
   manager->setDeviceConnected(false);
-  if (manager->onDisconnectCallback)
-  {
-    manager->onDisconnectCallback();
-  }
+  manager->disconnectPending = true;
   // Hanya restart advertising jika BLE masih enabled
   if (manager->isEnabled())
   {
@@ -33,11 +30,11 @@ MyBLECharacteristicCallbacks::MyBLECharacteristicCallbacks(BLEManager *mgr) : ma
 
 void MyBLECharacteristicCallbacks::onWrite(BLECharacteristic *pCharacteristic)
 {
-  std::string value = pCharacteristic->getValue();
-  if (value.length() > 0)
+  // Jangan parse atau render di task BLE, cukup salin ke antrean
+  size_t length = pCharacteristic->getLength();
+  if (length > 0)
   {
-    String message = String(value.c_str());
-    manager->handleMessage(message);
+    manager->enqueueMessage(pCharacteristic->getData(), length);
   }
 }
 
@@ -46,13 +43,20 @@ BLEManager::BLEManager()
   pServer = nullptr;
   pService = nullptr;
   pCharacteristic = nullptr;
+  pMirrorCharacteristic = nullptr;
   deviceConnected = false;
   bleEnabled = false;
   pCallbacks = nullptr;
   pCharCallbacks = nullptr;
   onMessageCallback = nullptr;
+  onBinaryCallback = nullptr;
   onConnectCallback = nullptr;
   onDisconnectCallback = nullptr;
+  connectPending = false;
+  disconnectPending = false;
+  memset(processedCount, 0, sizeof(processedCount));
+  memset(coalescedCount, 0, sizeof(coalescedCount));
+  amplitudeSuperseded = false;
 }
 
 void BLEManager::begin(const char *deviceName)
@@ -81,6 +85,13 @@ void BLEManager::begin(const char *deviceName)
   pCharacteristic->addDescriptor(pDescriptor);
 
   pCharacteristic->setValue("Ready");
+
+  BLEUUID mirrorUUID("1999eae1-d5ad-4909-aff3-4a8875149db5");
+  pMirrorCharacteristic = pService->createCharacteristic(
+      mirrorUUID,
+      BLECharacteristic::PROPERTY_NOTIFY);
+  pMirrorCharacteristic->addDescriptor(new BLE2902());
+
   pService->start();
 
   BLEAdvertising *pAdvertising = BLEDevice::getAdvertising();
@@ -101,7 +112,7 @@ void BLEManager::turnOn()
     if (pServer != nullptr)
     {
       BLEDevice::startAdvertising();
-      Serial.println("BLE: Advertising started");
+      Log.println("BLE: Advertising started");
     }
   }
 }
@@ -116,12 +127,12 @@ void BLEManager::turnOff()
     if (deviceConnected && pServer != nullptr)
     {
       pServer->disconnect(pServer->getConnId());
-      Serial.println("BLE: Connection disconnected");
+      Log.println("BLE: Connection disconnected");
     }
 
     // Hentikan advertising
     BLEDevice::getAdvertising()->stop();
-    Serial.println("BLE: Advertising stopped");
+    Log.println("BLE: Advertising stopped");
   }
 }
 
@@ -144,24 +155,199 @@ void BLEManager::sendData(String data)
   }
 }
 
+void BLEManager::sendData(const uint8_t *data, size_t length)
+{
+  if (deviceConnected && pMirrorCharacteristic != nullptr && bleEnabled)
+  {
+    pMirrorCharacteristic->setValue((uint8_t *)data, length);
+    pMirrorCharacteristic->notify();
+  }
+}
+
+size_t BLEManager::getMaxPayload()
+{
+  // MTU hasil negosiasi dikurangi 3 byte header ATT, minimal MTU default 23
+  uint16_t mtu = 23;
+  if (deviceConnected && pServer != nullptr)
+  {
+    mtu = max((uint16_t)23, pServer->getPeerMTU(pServer->getConnId()));
+  }
+  return mtu - 3;
+}
+
 void BLEManager::setDeviceConnected(bool connected)
 {
   deviceConnected = connected;
 }
 
-void BLEManager::handleMessage(String message)
+void BLEManager::handleMessage(char *message, size_t length)
 {
   if (onMessageCallback)
   {
-    onMessageCallback(message);
+    onMessageCallback(message, length);
   }
 }
 
-void BLEManager::setOnMessageCallback(std::function<void(String)> callback)
+void BLEManager::enqueueMessage(const uint8_t *data, size_t length)
+{
+  // Antrean penuh: pesan dibuang dan dihitung, tanpa Serial di task BLE
+  messageQueue.push(data, length);
+}
+
+void BLEManager::processMessages()
+{
+  // Connect dan disconnect bisa sama-sama tertunda; urutkan sehingga event
+  // terakhir sesuai status koneksi saat ini
+  bool connected = deviceConnected;
+  if (connected && disconnectPending.exchange(false) && onDisconnectCallback)
+  {
+    onDisconnectCallback();
+  }
+  if (connectPending.exchange(false) && onConnectCallback)
+  {
+    onConnectCallback();
+  }
+
+  // Maksimal isi antrean saat ini, pesan yang masuk selama diproses
+  // menunggu loop berikutnya
+  int pending = messageQueue.size();
+
+  // Posisi pesan terbaru tiap jenis di batch ini; pesan latest-wins
+  // sebelum posisi itu sudah basi
+  MessageKind kinds[QUEUE_SLOTS];
+  int latest[MESSAGE_KIND_COUNT];
+  for (int k = 0; k < MESSAGE_KIND_COUNT; k++)
+  {
+    latest[k] = -1;
+  }
+  for (int i = 0; i < pending; i++)
+  {
+    size_t length;
+    const char *data = messageQueue.peek(i, &length);
+    kinds[i] = data ? classify(data, length) : MESSAGE_OTHER;
+    latest[kinds[i]] = i;
+  }
+
+  // JSON media juga membawa amplitudo, jadi amplitudo terbaru ada di posisi
+  // terakhir dari kedua jenis. Frame biner sebelum posisi itu basi; JSON
+  // media yang disusul frame biner hanya dipakai metadatanya
+  int latestAmplitude = max(latest[MESSAGE_MEDIA], latest[MESSAGE_AMPLITUDE]);
+
+  for (int i = 0; i < pending; i++)
+  {
+    size_t length;
+    char *data = messageQueue.front(&length);
+    if (!data)
+      break;
+
+    MessageKind kind = kinds[i];
+    bool stale = isLatestWins(kind) && i != latest[kind];
+    if (kind == MESSAGE_AMPLITUDE && i != latestAmplitude)
+    {
+      stale = true;
+    }
+    if (stale)
+    {
+      coalescedCount[kind]++;
+      messageQueue.pop();
+      continue;
+    }
+
+    if (MediaFrame::isBinary((const uint8_t *)data, length))
+    {
+      if (onBinaryCallback)
+        onBinaryCallback((const uint8_t *)data, length);
+    }
+    else
+    {
+      amplitudeSuperseded = kind == MESSAGE_MEDIA && latestAmplitude > i;
+      handleMessage(data, length);
+      amplitudeSuperseded = false;
+    }
+    processedCount[kind]++;
+    // Slot baru dilepas setelah callback selesai memakainya
+    messageQueue.pop();
+  }
+
+  if (disconnectPending.exchange(false) && onDisconnectCallback)
+  {
+    onDisconnectCallback();
+  }
+}
+
+MessageKind BLEManager::classify(const char *data, size_t length)
+{
+  if (MediaFrame::isBinary((const uint8_t *)data, length))
+  {
+    return (uint8_t)data[0] == MediaFrame::TYPE_AMPLITUDE ? MESSAGE_AMPLITUDE : MESSAGE_OTHER;
+  }
+
+  size_t typeLength = 0;
+  const char *type = MessageParser::findType(data, &typeLength);
+  if (!type)
+    return MESSAGE_OTHER;
+  if (typeLength == 5 && strncmp(type, "media", 5) == 0)
+    return MESSAGE_MEDIA;
+  if (typeLength == 12 && strncmp(type, "notification", 12) == 0)
+    return MESSAGE_NOTIFICATION;
+  return MESSAGE_OTHER;
+}
+
+bool BLEManager::isLatestWins(MessageKind kind)
+{
+  return kind == MESSAGE_MEDIA || kind == MESSAGE_AMPLITUDE;
+}
+
+bool BLEManager::isAmplitudeSuperseded()
+{
+  return amplitudeSuperseded;
+}
+
+int BLEManager::getQueueSize()
+{
+  return messageQueue.size();
+}
+
+int BLEManager::getQueueCapacity()
+{
+  return messageQueue.capacity();
+}
+
+uint32_t BLEManager::getQueueHighWater()
+{
+  return messageQueue.getHighWater();
+}
+
+uint32_t BLEManager::getQueueOverflows()
+{
+  return messageQueue.getOverflows();
+}
+
+uint32_t BLEManager::getQueueTruncated()
+{
+  return messageQueue.getTruncated();
+}
+
+uint32_t BLEManager::getProcessedCount(MessageKind kind)
+{
+  return processedCount[kind];
+}
+
+uint32_t BLEManager::getCoalescedCount(MessageKind kind)
+{
+  return coalescedCount[kind];
+}
+
+void BLEManager::setOnMessageCallback(std::function<void(char *, size_t)> callback)
 {
   onMessageCallback = callback;
 }
 
+void BLEManager::setOnBinaryCallback(std::function<void(const uint8_t *, size_t)> callback)
+{
+  onBinaryCallback = callback;
+}
+
 void BLEManager::setOnConnectCallback(std::function<void()> callback)
 {
   onConnectCallback = callback;
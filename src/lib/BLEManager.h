@@ -7,9 +7,22 @@
 #include <BLEUtils.h>
 #include <BLE2902.h>
 #include <functional>
+#include <atomic>
+#include "MessageQueue.h"
 
 class BLEManager;
 
+// Jenis pesan di antrean. Media dan amplitudo biner hanya berarti nilai
+// terbarunya, jadi yang lama di antrean dibuang; jenis lain selalu diproses
+enum MessageKind
+{
+  MESSAGE_NOTIFICATION,
+  MESSAGE_MEDIA,     // JSON "media", membawa status lengkap
+  MESSAGE_AMPLITUDE, // frame amplitudo biner (MediaFrame.h)
+  MESSAGE_OTHER,
+  MESSAGE_KIND_COUNT
+};
+
 class MyBLEServerCallbacks : public BLEServerCallbacks
 {
 private:
@@ -37,15 +50,35 @@ private:
   BLEServer *pServer;
   BLEService *pService;
   BLECharacteristic *pCharacteristic;
+  BLECharacteristic *pMirrorCharacteristic;
   bool deviceConnected;
   bool bleEnabled;
   MyBLEServerCallbacks *pCallbacks;
   MyBLECharacteristicCallbacks *pCharCallbacks;
 
-  std::function<void(String)> onMessageCallback;
+  std::function<void(char *, size_t)> onMessageCallback;
+  std::function<void(const uint8_t *, size_t)> onBinaryCallback;
   std::function<void()> onConnectCallback;
   std::function<void()> onDisconnectCallback;
 
+  // Write dan event koneksi datang dari task Bluedroid; disalin ke sini
+  // lalu dijalankan oleh processMessages() di loop(), satu thread dengan render.
+  // Slot seukuran nilai attribute maksimum (512 byte).
+  static const int QUEUE_SLOTS = 8;
+  static const int QUEUE_SLOT_SIZE = 512;
+  MessageQueue<QUEUE_SLOTS, QUEUE_SLOT_SIZE> messageQueue;
+  std::atomic<bool> connectPending;
+  std::atomic<bool> disconnectPending;
+
+  // Hitungan per MessageKind, hanya disentuh processMessages()
+  uint32_t processedCount[MESSAGE_KIND_COUNT];
+  uint32_t coalescedCount[MESSAGE_KIND_COUNT];
+  bool amplitudeSuperseded;
+
+  void enqueueMessage(const uint8_t *data, size_t length);
+  static MessageKind classify(const char *data, size_t length);
+  static bool isLatestWins(MessageKind kind);
+
   friend class MyBLEServerCallbacks;
   friend class MyBLECharacteristicCallbacks;
 
@@ -54,18 +87,42 @@ public:
   void begin(const char *deviceName);
   bool isConnected();
   void sendData(String data);
+  // Data biner lewat characteristic notify terpisah (stream mirror layar),
+  // length tidak boleh melebihi getMaxPayload()
+  void sendData(const uint8_t *data, size_t length);
+  size_t getMaxPayload();
 
   void turnOn();
   void turnOff();
 
   bool isEnabled();
 
-  void setOnMessageCallback(std::function<void(String)> callback);
+  // Pesan teks diteruskan langsung dari slot antrean (diakhiri '\0'),
+  // boleh diubah di tempat selama callback berjalan
+  void setOnMessageCallback(std::function<void(char *, size_t)> callback);
+  // Pesan yang diawali byte >= 0x80 (lihat MediaFrame.h), diteruskan
+  // langsung dari slot antrean tanpa String
+  void setOnBinaryCallback(std::function<void(const uint8_t *, size_t)> callback);
   void setOnConnectCallback(std::function<void()> callback);
   void setOnDisconnectCallback(std::function<void()> callback);
 
   void setDeviceConnected(bool connected);
-  void handleMessage(String message);
+  void handleMessage(char *message, size_t length);
+
+  // Dipanggil dari loop(): menjalankan callback connect/disconnect dan
+  // pesan yang sudah masuk antrean
+  void processMessages();
+  int getQueueSize();
+  int getQueueCapacity();
+  uint32_t getQueueHighWater();
+  uint32_t getQueueOverflows();
+  uint32_t getQueueTruncated();
+  uint32_t getProcessedCount(MessageKind kind);
+  // Pesan yang dibuang karena pesan sejenis yang lebih baru sudah antre
+  uint32_t getCoalescedCount(MessageKind kind);
+  // Hanya berarti di dalam callback pesan: true jika frame amplitudo yang
+  // lebih baru sudah antre, sehingga amplitudo di pesan media ini basi
+  bool isAmplitudeSuperseded();
 };
 
 #endif
\ No newline at end of file
@@ -1,4 +1,5 @@
 #include "ConfigManager.h"
+#include "SerialLog.h"
 
 const char *ConfigManager::WIFI_NAMESPACE = "wifi";
 const char *ConfigManager::SETTINGS_NAMESPACE = "settings";
@@ -27,7 +28,7 @@ bool ConfigManager::addWiFiConfig(const String &ssid, const String &password)
       preferences.putString(passKey.c_str(), password);
       preferences.end();
 
-      Serial.printf("✅ WiFi '%s' updated\n", ssid.c_str());
+      Log.printf("✅ WiFi '%s' updated\n", ssid.c_str());
       return true;
     }
   }
@@ -35,7 +36,7 @@ bool ConfigManager::addWiFiConfig(const String &ssid, const String &password)
   if (count >= MAX_WIFI_NETWORKS)
   {
     preferences.end();
-    Serial.println("❌ Sudah mencapai maksimal WiFi networks!");
+    Log.println("❌ Sudah mencapai maksimal WiFi networks!");
     return false;
   }
 
@@ -47,7 +48,7 @@ bool ConfigManager::addWiFiConfig(const String &ssid, const String &password)
   preferences.putInt("count", count + 1);
   preferences.end();
 
-  Serial.printf("✅ WiFi #%d saved: %s\n", count + 1, ssid.c_str());
+  Log.printf("✅ WiFi #%d saved: %s\n", count + 1, ssid.c_str());
   return true;
 }
 
@@ -110,13 +111,13 @@ bool ConfigManager::removeWiFiConfig(const String &ssid)
       preferences.putInt("count", count - 1);
       preferences.end();
 
-      Serial.printf("🗑️ WiFi '%s' dihapus\n", ssid.c_str());
+      Log.printf("🗑️ WiFi '%s' dihapus\n", ssid.c_str());
       return true;
     }
   }
 
   preferences.end();
-  Serial.printf("❌ WiFi '%s' tidak ditemukan\n", ssid.c_str());
+  Log.printf("❌ WiFi '%s' tidak ditemukan\n", ssid.c_str());
   return false;
 }
 
@@ -125,7 +126,7 @@ void ConfigManager::clearAllWiFiConfigs()
   preferences.begin(WIFI_NAMESPACE, false);
   preferences.clear();
   preferences.end();
-  Serial.println("🗑️ Semua WiFi configs dihapus");
+  Log.println("🗑️ Semua WiFi configs dihapus");
 }
 
 int ConfigManager::getWiFiCount()
@@ -165,6 +166,13 @@ void ConfigManager::saveSettingsConfig(const String &key, const bool &value)
   preferences.end();
 }
 
+void ConfigManager::saveSettingsConfig(const String &key, const uint32_t &value)
+{
+  preferences.begin(SETTINGS_NAMESPACE, false);
+  preferences.putUInt(key.c_str(), value);
+  preferences.end();
+}
+
 SettingConfig ConfigManager::loadSettingsConfig()
 {
   SettingConfig config;
@@ -172,6 +180,8 @@ SettingConfig ConfigManager::loadSettingsConfig()
   preferences.begin(SETTINGS_NAMESPACE, true);
   config.bluetooth = preferences.getBool("bluetooth", false);
   config.wifi = preferences.getBool("wifi", false);
+  config.i2cClock = preferences.getUInt("i2c_clock", 0);
+  config.grayscale = preferences.getBool("grayscale", false);
 
   preferences.end();
   return config;
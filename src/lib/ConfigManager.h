@@ -16,6 +16,8 @@ struct SettingConfig
 {
   bool bluetooth;
   bool wifi;
+  uint32_t i2cClock; // 0 jika belum pernah dikalibrasi
+  bool grayscale;
 };
 
 class ConfigManager
@@ -43,6 +45,7 @@ public:
   String getDeviceID();
 
   void saveSettingsConfig(const String &key, const bool &value);
+  void saveSettingsConfig(const String &key, const uint32_t &value);
   SettingConfig loadSettingsConfig();
 };
 
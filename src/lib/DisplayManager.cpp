@@ -0,0 +1,1553 @@
+#include "DisplayManager.h"
+#include "SerialLog.h"
+
+#ifdef I2C_BUFFER_LENGTH
+static const int WIRE_CHUNK = I2C_BUFFER_LENGTH - 1;
+#else
+static const int WIRE_CHUNK = 31;
+#endif
+
+static const uint32_t CALIBRATION_CLOCKS[] = {100000, 400000, 700000, 1000000};
+
+// Perintah SSD1327 yang berbeda dari SSD1306 (contrast 0x81 dan on/off sama)
+#define SSD1327_SETCOLUMN 0x15
+#define SSD1327_SETROW 0x75
+
+static const uint8_t SSD1327_INIT[] = {
+    0xAE,       // display off
+    0x81, 0x80, // contrast
+    0xA0, 0x51, // remap: nibble tinggi = piksel kiri, COM dibalik
+    0xA1, 0x00, // start line
+    0xA2, 0x00, // display offset
+    0xA8, 0x7F, // multiplex 128
+    0xB1, 0x11, // phase length
+    0xB3, 0x00, // clock divider
+    0xAB, 0x01, // regulator internal
+    0xB6, 0x04, // precharge kedua
+    0xBE, 0x0F, // VCOMH
+    0xBC, 0x08, // precharge
+    0xD5, 0x62, // function selection B
+    0xFD, 0x12, // unlock
+    0xB9,       // tabel gray linear
+    0xA4,       // normal display
+    0xAF};      // display on
+
+// Level abu-abu plane (0-3) ke piksel 4-bit; piksel mono putih = 15
+static const uint8_t GRAY4_LEVELS[4] = {0, 5, 10, 15};
+
+DisplayManager::DisplayManager(uint8_t w, uint8_t h, TwoWire *twi, int8_t rst_pin)
+    : Adafruit_SSD1306(w, h, twi, rst_pin),
+      shadowBuffer(nullptr),
+      shadowValid(false),
+      partialFlush(true),
+      frontBuffer(nullptr),
+      asyncFlush(false),
+      flushTask(nullptr),
+      flushIdle(nullptr),
+      busMutex(nullptr),
+      fastRaster(true),
+      startLine(0),
+      frontStartLine(0),
+      panelStartLine(0),
+      panelContrast(0),
+      panelOn(true),
+      fadeInPending(false),
+      fadingIn(false),
+      fadeRequested(0),
+      fadeStart(0),
+      fadeDuration(0),
+      fadingOut(false),
+      framePending(false),
+      fadeOutFrom(0),
+      fadeOutStart(0),
+      fadeOutDuration(0),
+      grayscale(false),
+      grayPlanes(nullptr),
+      frontGrayPlanes(nullptr),
+      subframeBuffer(nullptr),
+      graySubframe(0),
+      subframeWindowStart(0),
+      subframeWindowCount(0),
+      glyphCp437(false),
+      mirror(nullptr),
+      fadePartner(nullptr)
+{
+  init();
+}
+
+DisplayManager::DisplayManager(uint8_t w, uint8_t h, SPIClass *spi, int8_t dc_pin, int8_t rst_pin, int8_t cs_pin, uint32_t bitrate)
+    : Adafruit_SSD1306(w, h, spi, dc_pin, rst_pin, cs_pin, bitrate),
+      shadowBuffer(nullptr),
+      shadowValid(false),
+      partialFlush(true),
+      frontBuffer(nullptr),
+      asyncFlush(false),
+      flushTask(nullptr),
+      flushIdle(nullptr),
+      busMutex(nullptr),
+      fastRaster(true),
+      startLine(0),
+      frontStartLine(0),
+      panelStartLine(0),
+      panelContrast(0),
+      panelOn(true),
+      fadeInPending(false),
+      fadingIn(false),
+      fadeRequested(0),
+      fadeStart(0),
+      fadeDuration(0),
+      fadingOut(false),
+      framePending(false),
+      fadeOutFrom(0),
+      fadeOutStart(0),
+      fadeOutDuration(0),
+      grayscale(false),
+      grayPlanes(nullptr),
+      frontGrayPlanes(nullptr),
+      subframeBuffer(nullptr),
+      graySubframe(0),
+      subframeWindowStart(0),
+      subframeWindowCount(0),
+      glyphCp437(false),
+      mirror(nullptr),
+      fadePartner(nullptr)
+{
+  // Di mode SPI wireClk menyimpan clock SPI, dipakai oleh getBusClock()
+  wireClk = bitrate;
+  init();
+}
+
+void DisplayManager::init()
+{
+  invalidateGlyphCache();
+  underlay = nullptr;
+  overlayShown = false;
+  for (int i = 0; i < SNAPSHOT_SLOTS; i++)
+  {
+    snapshots[i] = nullptr;
+    snapshotSizes[i] = 0;
+    snapshotValid[i] = false;
+  }
+  calibration.clock = 0;
+  calibration.frameTime = 0;
+  calibration.bytesPerSecond = 0;
+  calibration.errors = 0;
+  portMUX_INITIALIZE(&statsLock);
+  flushCounts = FlushStats();
+  resetFlushStats();
+}
+
+DisplayManager::~DisplayManager()
+{
+  if (flushTask)
+  {
+    waitForFlush();
+    vTaskDelete(flushTask);
+    flushTask = nullptr;
+  }
+  if (frontBuffer)
+  {
+    free(frontBuffer);
+    frontBuffer = nullptr;
+  }
+  for (int i = 0; i < SNAPSHOT_SLOTS; i++)
+  {
+    free(snapshots[i]);
+  }
+  free(grayPlanes);
+  free(frontGrayPlanes);
+  free(subframeBuffer);
+  free(underlay);
+  if (shadowBuffer)
+  {
+    free(shadowBuffer);
+    shadowBuffer = nullptr;
+  }
+}
+
+bool DisplayManager::begin(uint8_t switchvcc, uint8_t i2caddr)
+{
+  if (!busMutex)
+  {
+    busMutex = xSemaphoreCreateMutex();
+  }
+
+  lockBus();
+  bool ok = NATIVE_GRAY ? beginSSD1327(i2caddr) : Adafruit_SSD1306::begin(switchvcc, i2caddr);
+  unlockBus();
+
+  if (!ok)
+    return false;
+
+  // Shadow SSD1327 juga menyimpan kedua plane abu-abu
+  if (!shadowBuffer)
+  {
+    shadowBuffer = (uint8_t *)malloc(getBufferSize() * (NATIVE_GRAY ? 3 : 1));
+  }
+
+  // Isi GDDRAM belum diketahui, flush pertama selalu penuh.
+  // Inisialisasi Adafruit juga mengembalikan start line ke 0.
+  shadowValid = false;
+  panelStartLine = 0;
+  panelContrast = contrast;
+  panelOn = true;
+  return true;
+}
+
+int DisplayManager::getPageCount()
+{
+  return (HEIGHT + 7) / 8;
+}
+
+int DisplayManager::getBufferSize()
+{
+  return WIDTH * getPageCount();
+}
+
+// Byte GDDRAM satu frame penuh di panel
+int DisplayManager::getFrameBytes()
+{
+  return NATIVE_GRAY ? WIDTH * HEIGHT / 2 : getBufferSize();
+}
+
+bool DisplayManager::beginSSD1327(uint8_t addr)
+{
+  // Buffer page dan plane abu-abu dialokasikan di sini karena init
+  // Adafruit_SSD1306 mengirim perintah SSD1306
+  int size = getBufferSize();
+  if (!buffer)
+    buffer = (uint8_t *)malloc(size);
+  if (!grayPlanes)
+    grayPlanes = (uint8_t *)malloc(size * 2);
+  if (!buffer || !grayPlanes)
+  {
+    Log.println("[Display] SSD1327: no memory for buffers");
+    return false;
+  }
+  clearDisplay();
+
+  i2caddr = addr ? addr : PANEL_ADDRESS;
+  wire->begin();
+
+  if (rstPin >= 0)
+  {
+    pinMode(rstPin, OUTPUT);
+    digitalWrite(rstPin, LOW);
+    delay(10);
+    digitalWrite(rstPin, HIGH);
+    delay(10);
+  }
+
+  ssd1306_commandList(SSD1327_INIT, sizeof(SSD1327_INIT));
+  contrast = 0x80;
+  return true;
+}
+
+void DisplayManager::clearDisplay()
+{
+  Adafruit_SSD1306::clearDisplay();
+  if (grayPlanes)
+  {
+    memset(grayPlanes, 0, getBufferSize() * 2);
+  }
+}
+
+void DisplayManager::display()
+{
+  // Selama fade-out panel masih menampilkan layar lama; frame terakhir
+  // dikirim oleh update() setelah panel mati
+  if (fadingOut)
+  {
+    framePending = true;
+    return;
+  }
+
+  portENTER_CRITICAL(&statsLock);
+  stats.frames++;
+  portEXIT_CRITICAL(&statsLock);
+
+  bool overlaid = drawOverlay();
+  submitFrame();
+
+  // Buffer render kembali berisi layar tanpa overlay, sehingga snapshot
+  // dan frame yang tidak dirender ulang tidak ikut menyimpan overlay
+  if (overlaid)
+  {
+    memcpy(buffer, underlay, getBufferSize());
+  }
+}
+
+bool DisplayManager::drawOverlay()
+{
+  overlayShown = false;
+  if (!overlay)
+    return false;
+
+  int size = getBufferSize();
+  if (!underlay)
+  {
+    underlay = (uint8_t *)malloc(size);
+  }
+  if (underlay)
+  {
+    memcpy(underlay, buffer, size);
+  }
+
+  if (!overlay())
+    return false;
+
+  overlayShown = true;
+  startLine = 0;
+  // Tanpa memori salinan, overlay tetap tertinggal di buffer seperti dulu
+  return underlay != nullptr;
+}
+
+void DisplayManager::submitFrame()
+{
+  if (mirror)
+  {
+    memcpy(mirror->getBuffer(), buffer, getBufferSize());
+    if (grayPlanes && mirror->grayPlanes)
+    {
+      memcpy(mirror->grayPlanes, grayPlanes, getBufferSize() * 2);
+    }
+    mirror->startLine = startLine;
+    mirror->display();
+  }
+
+  if (frameListener)
+  {
+    frameListener(buffer, startLine);
+  }
+
+  if (!asyncFlush)
+  {
+    flushFrame(buffer, grayPlanes, startLine);
+    return;
+  }
+
+  // Tunggu frame sebelumnya selesai dikirim, lalu serahkan frame ini ke
+  // flush task dan langsung kembali ke render
+  unsigned long waitStart = micros();
+  xSemaphoreTake(flushIdle, portMAX_DELAY);
+  unsigned long waited = micros() - waitStart;
+  portENTER_CRITICAL(&statsLock);
+  stats.waitTime += waited;
+  portEXIT_CRITICAL(&statsLock);
+
+  memcpy(frontBuffer, buffer, getBufferSize());
+  frontStartLine = startLine;
+
+  if (NATIVE_GRAY)
+  {
+    memcpy(frontGrayPlanes, grayPlanes, getBufferSize() * 2);
+  }
+  else if (grayscale)
+  {
+    // Flush task terus berjalan dan hanya memegang front buffer saat
+    // menyusun subframe, jadi front buffer langsung dilepas lagi
+    memcpy(frontGrayPlanes, grayPlanes, getBufferSize() * 2);
+    xSemaphoreGive(flushIdle);
+    return;
+  }
+  xTaskNotifyGive(flushTask);
+}
+
+bool DisplayManager::isSpi()
+{
+  return wire == nullptr;
+}
+
+void DisplayManager::beginTransfer()
+{
+  if (isSpi())
+  {
+    spi->beginTransaction(spiSettings);
+    digitalWrite(csPin, LOW);
+  }
+  else
+  {
+    wire->setClock(wireClk);
+  }
+}
+
+void DisplayManager::endTransfer()
+{
+  if (isSpi())
+  {
+    digitalWrite(csPin, HIGH);
+    spi->endTransaction();
+  }
+  else
+  {
+    wire->setClock(restoreClk);
+  }
+}
+
+int DisplayManager::sendData(const uint8_t *data, int length)
+{
+  // SPI: satu burst dengan D/C tinggi, tanpa batas buffer Wire dan ACK
+  if (isSpi())
+  {
+    digitalWrite(dcPin, HIGH);
+    spi->writeBytes(data, length);
+    return 0;
+  }
+
+  int errors = 0;
+  while (length > 0)
+  {
+    int chunk = min(length, WIRE_CHUNK);
+    wire->beginTransmission(i2caddr);
+    wire->write((uint8_t)0x40);
+    wire->write(data, chunk);
+    if (wire->endTransmission() != 0)
+    {
+      errors++;
+    }
+
+    data += chunk;
+    length -= chunk;
+  }
+  return errors;
+}
+
+void DisplayManager::flushFrame(const uint8_t *frame, const uint8_t *planes, uint8_t line)
+{
+  lockBus();
+  unsigned long start = micros();
+  flushCounts = FlushStats();
+
+  beginTransfer();
+  if (!partialFlush || !shadowValid || !shadowBuffer)
+  {
+    flushFull(frame, planes);
+  }
+  else if (NATIVE_GRAY)
+  {
+    flushDirtyGray(frame, planes);
+  }
+  else
+  {
+    flushDirty(frame);
+  }
+
+  // Start line dikirim setelah data agar geseran dan isi frame berganti bersama
+  if (line != panelStartLine)
+  {
+    ssd1306_command1(SSD1306_SETSTARTLINE | line);
+    panelStartLine = line;
+    flushCounts.startLineSet++;
+  }
+
+  // Panel baru dinyalakan setelah frame pertama layar baru ada di GDDRAM.
+  // Subframe grayscale selama fade-out masih milik layar lama.
+  if (fadeInPending && !fadingOut)
+  {
+    startFadeIn();
+  }
+  endTransfer();
+
+  unsigned long elapsed = micros() - start;
+  portENTER_CRITICAL(&statsLock);
+  stats.fullFlushes += flushCounts.fullFlushes;
+  stats.windowsSent += flushCounts.windowsSent;
+  stats.bytesSent += flushCounts.bytesSent;
+  stats.startLineSet += flushCounts.startLineSet;
+  stats.lastFlushTime = elapsed;
+  portEXIT_CRITICAL(&statsLock);
+  unlockBus();
+}
+
+void DisplayManager::flushFull(const uint8_t *frame, const uint8_t *planes)
+{
+  sendFrame(frame, planes);
+  flushCounts.fullFlushes++;
+
+  if (shadowBuffer)
+  {
+    memcpy(shadowBuffer, frame, getBufferSize());
+    if (NATIVE_GRAY)
+    {
+      memcpy(shadowBuffer + getBufferSize(), planes, getBufferSize() * 2);
+    }
+    shadowValid = true;
+  }
+}
+
+int DisplayManager::sendFrame(const uint8_t *frame, const uint8_t *planes)
+{
+  if (NATIVE_GRAY)
+  {
+    return sendGrayWindow(0, getPageCount() - 1, 0, WIDTH - 1, frame, planes);
+  }
+  return sendWindow(0, getPageCount() - 1, 0, WIDTH - 1, frame);
+}
+
+void DisplayManager::flushDirty(const uint8_t *frame)
+{
+  for (int page = 0; page < getPageCount(); page++)
+  {
+    const uint8_t *row = frame + page * WIDTH;
+    uint8_t *shadowRow = shadowBuffer + page * WIDTH;
+
+    int col = 0;
+    while (col < WIDTH)
+    {
+      if (row[col] == shadowRow[col])
+      {
+        col++;
+        continue;
+      }
+
+      // Perluas window selama celah kolom yang sama masih pendek
+      int runStart = col;
+      int runEnd = col;
+      for (int c = col + 1; c < WIDTH && c - runEnd <= WINDOW_MERGE_GAP; c++)
+      {
+        if (row[c] != shadowRow[c])
+        {
+          runEnd = c;
+        }
+      }
+
+      sendWindow(page, page, runStart, runEnd, row + runStart);
+      memcpy(shadowRow + runStart, row + runStart, runEnd - runStart + 1);
+
+      col = runEnd + 1;
+    }
+  }
+}
+
+int DisplayManager::sendWindow(uint8_t pageStart, uint8_t pageEnd, uint8_t colStart, uint8_t colEnd, const uint8_t *data)
+{
+  const uint8_t window[] = {
+      SSD1306_PAGEADDR, pageStart, pageEnd,
+      SSD1306_COLUMNADDR, colStart, colEnd};
+  ssd1306_commandList(window, sizeof(window));
+
+  int length = (pageEnd - pageStart + 1) * (colEnd - colStart + 1);
+  flushCounts.windowsSent++;
+  flushCounts.bytesSent += length;
+
+  return sendData(data, length);
+}
+
+void DisplayManager::flushDirtyGray(const uint8_t *frame, const uint8_t *planes)
+{
+  // Sama dengan flushDirty, tapi satu kolom page berubah jika byte mono
+  // atau salah satu plane abu-abu berbeda dari shadow
+  int size = getBufferSize();
+  const uint8_t *low = planes;
+  const uint8_t *high = planes + size;
+  uint8_t *shadowLow = shadowBuffer + size;
+  uint8_t *shadowHigh = shadowBuffer + size * 2;
+
+  for (int page = 0; page < getPageCount(); page++)
+  {
+    int base = page * WIDTH;
+
+    int col = 0;
+    while (col < WIDTH)
+    {
+      int i = base + col;
+      if (frame[i] == shadowBuffer[i] && low[i] == shadowLow[i] && high[i] == shadowHigh[i])
+      {
+        col++;
+        continue;
+      }
+
+      int runStart = col;
+      int runEnd = col;
+      for (int c = col + 1; c < WIDTH && c - runEnd <= WINDOW_MERGE_GAP; c++)
+      {
+        i = base + c;
+        if (frame[i] != shadowBuffer[i] || low[i] != shadowLow[i] || high[i] != shadowHigh[i])
+        {
+          runEnd = c;
+        }
+      }
+
+      // Satu byte GDDRAM SSD1327 berisi dua piksel, window dibulatkan ke pasangan kolom
+      runStart &= ~1;
+      runEnd |= 1;
+      if (runEnd >= WIDTH)
+        runEnd = WIDTH - 1;
+
+      sendGrayWindow(page, page, runStart, runEnd, frame, planes);
+      int count = runEnd - runStart + 1;
+      memcpy(shadowBuffer + base + runStart, frame + base + runStart, count);
+      memcpy(shadowLow + base + runStart, low + base + runStart, count);
+      memcpy(shadowHigh + base + runStart, high + base + runStart, count);
+
+      col = runEnd + 1;
+    }
+  }
+}
+
+int DisplayManager::sendGrayWindow(uint8_t pageStart, uint8_t pageEnd, uint8_t colStart, uint8_t colEnd,
+                                   const uint8_t *frame, const uint8_t *planes)
+{
+  int errors = 0;
+  int size = getBufferSize();
+  int rowStart = pageStart * 8;
+  int rowEnd = min(pageEnd * 8 + 7, HEIGHT - 1);
+
+  const uint8_t window[] = {
+      SSD1327_SETCOLUMN, (uint8_t)(colStart / 2), (uint8_t)(colEnd / 2),
+      SSD1327_SETROW, (uint8_t)rowStart, (uint8_t)rowEnd};
+  ssd1306_commandList(window, sizeof(window));
+  flushCounts.windowsSent++;
+
+  // Dikonversi per chunk I2C, tanpa buffer 4bpp seukuran panel
+  uint8_t chunk[WIRE_CHUNK];
+  int filled = 0;
+  for (int row = rowStart; row <= rowEnd; row++)
+  {
+    int offset = (row >> 3) * WIDTH;
+    uint8_t bit = 1 << (row & 7);
+
+    for (int col = colStart; col <= colEnd; col += 2)
+    {
+      uint8_t pair = 0;
+      for (int half = 0; half < 2; half++)
+      {
+        int i = offset + col + half;
+        uint8_t level;
+        if (frame[i] & bit)
+          level = 15;
+        else
+          level = GRAY4_LEVELS[((planes[i] & bit) ? 1 : 0) | ((planes[size + i] & bit) ? 2 : 0)];
+        pair |= half ? level : level << 4;
+      }
+
+      chunk[filled++] = pair;
+      if (filled == WIRE_CHUNK)
+      {
+        errors += sendData(chunk, filled);
+        flushCounts.bytesSent += filled;
+        filled = 0;
+      }
+    }
+  }
+
+  if (filled > 0)
+  {
+    errors += sendData(chunk, filled);
+    flushCounts.bytesSent += filled;
+  }
+
+  return errors;
+}
+
+bool DisplayManager::saveSnapshot(int slot)
+{
+  if (slot < 0 || slot >= SNAPSHOT_SLOTS || !buffer)
+    return false;
+
+  // Plane abu-abu ikut disimpan jika sudah dialokasikan
+  int size = getBufferSize();
+  int needed = grayPlanes ? size * 3 : size;
+  if (snapshotSizes[slot] < needed)
+  {
+    uint8_t *grown = (uint8_t *)realloc(snapshots[slot], needed);
+    if (!grown)
+    {
+      snapshotValid[slot] = false;
+      return false;
+    }
+    snapshots[slot] = grown;
+    snapshotSizes[slot] = needed;
+  }
+
+  memcpy(snapshots[slot], buffer, size);
+  if (grayPlanes)
+  {
+    memcpy(snapshots[slot] + size, grayPlanes, size * 2);
+  }
+  snapshotValid[slot] = true;
+  return true;
+}
+
+bool DisplayManager::restoreSnapshot(int slot)
+{
+  if (slot < 0 || slot >= SNAPSHOT_SLOTS || !snapshotValid[slot])
+    return false;
+
+  // Buffer bisa sedang dibaca flush task hanya lewat front buffer, jadi
+  // menyalin ke buffer render aman tanpa menunggu flush
+  int size = getBufferSize();
+  memcpy(buffer, snapshots[slot], size);
+  if (grayPlanes)
+  {
+    if (snapshotSizes[slot] >= size * 3)
+      memcpy(grayPlanes, snapshots[slot] + size, size * 2);
+    else
+      memset(grayPlanes, 0, size * 2);
+  }
+  snapshotValid[slot] = false;
+  return true;
+}
+
+void DisplayManager::discardSnapshots()
+{
+  for (int i = 0; i < SNAPSHOT_SLOTS; i++)
+  {
+    snapshotValid[i] = false;
+  }
+}
+
+void DisplayManager::setOverlay(std::function<bool()> drawOverlay)
+{
+  overlay = drawOverlay;
+}
+
+void DisplayManager::setFrameListener(std::function<void(const uint8_t *frame, uint8_t startLine)> listener)
+{
+  frameListener = listener;
+}
+
+bool DisplayManager::useFastRaster()
+{
+  return fastRaster && buffer && rotation == 0;
+}
+
+void DisplayManager::fillPageRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color)
+{
+  fillPlaneRect(buffer, x, y, w, h, color);
+}
+
+void DisplayManager::fillPlaneRect(uint8_t *plane, int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color)
+{
+  if (x < 0)
+  {
+    w += x;
+    x = 0;
+  }
+  if (y < 0)
+  {
+    h += y;
+    y = 0;
+  }
+  if (x + w > WIDTH)
+  {
+    w = WIDTH - x;
+  }
+  if (y + h > HEIGHT)
+  {
+    h = HEIGHT - y;
+  }
+  if (w <= 0 || h <= 0)
+    return;
+
+  int yLast = y + h - 1;
+  int firstPage = y >> 3;
+  int lastPage = yLast >> 3;
+
+  for (int page = firstPage; page <= lastPage; page++)
+  {
+    // Mask bit untuk baris yang tertutup rect di page ini
+    uint8_t mask = 0xFF;
+    if (page == firstPage)
+    {
+      mask &= 0xFF << (y & 7);
+    }
+    if (page == lastPage)
+    {
+      mask &= 0xFF >> (7 - (yLast & 7));
+    }
+
+    uint8_t *ptr = plane + page * WIDTH + x;
+    int count = w;
+
+    switch (color)
+    {
+    case SSD1306_WHITE:
+      while (count--)
+        *ptr++ |= mask;
+      break;
+    case SSD1306_BLACK:
+      mask = ~mask;
+      while (count--)
+        *ptr++ &= mask;
+      break;
+    case SSD1306_INVERSE:
+      while (count--)
+        *ptr++ ^= mask;
+      break;
+    }
+  }
+}
+
+void DisplayManager::drawFastHLine(int16_t x, int16_t y, int16_t w, uint16_t color)
+{
+  if (!useFastRaster())
+  {
+    Adafruit_SSD1306::drawFastHLine(x, y, w, color);
+    return;
+  }
+  fillPageRect(x, y, w, 1, color);
+}
+
+void DisplayManager::drawFastVLine(int16_t x, int16_t y, int16_t h, uint16_t color)
+{
+  if (!useFastRaster())
+  {
+    Adafruit_SSD1306::drawFastVLine(x, y, h, color);
+    return;
+  }
+  fillPageRect(x, y, 1, h, color);
+}
+
+void DisplayManager::fillRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color)
+{
+  if (!useFastRaster())
+  {
+    Adafruit_SSD1306::fillRect(x, y, w, h, color);
+    return;
+  }
+  fillPageRect(x, y, w, h, color);
+}
+
+void DisplayManager::fillScreen(uint16_t color)
+{
+  if (!useFastRaster() || color == SSD1306_INVERSE)
+  {
+    Adafruit_SSD1306::fillScreen(color);
+    return;
+  }
+  memset(buffer, color == SSD1306_WHITE ? 0xFF : 0x00, getBufferSize());
+}
+
+void DisplayManager::blitColumn(int16_t x, int16_t y, uint8_t bits, uint16_t color)
+{
+  if (!bits || x < 0 || x >= WIDTH || y >= HEIGHT || y <= -8)
+    return;
+
+  // Potongan kolom bisa melintasi dua page jika y tidak kelipatan 8
+  if (y < 0)
+  {
+    bits >>= -y;
+    y = 0;
+  }
+  int page = y >> 3;
+  int shift = y & 7;
+  uint8_t parts[2] = {(uint8_t)(bits << shift), (uint8_t)(shift ? bits >> (8 - shift) : 0)};
+
+  for (int i = 0; i < 2 && page + i < getPageCount(); i++)
+  {
+    uint8_t mask = parts[i];
+    if (!mask)
+      continue;
+
+    // Baris di luar HEIGHT pada page terakhir tidak ikut ditulis
+    int rowsLeft = HEIGHT - (page + i) * 8;
+    if (rowsLeft < 8)
+      mask &= 0xFF >> (8 - rowsLeft);
+
+    uint8_t *ptr = buffer + (page + i) * WIDTH + x;
+    switch (color)
+    {
+    case SSD1306_WHITE:
+      *ptr |= mask;
+      break;
+    case SSD1306_BLACK:
+      *ptr &= ~mask;
+      break;
+    case SSD1306_INVERSE:
+      *ptr ^= mask;
+      break;
+    }
+  }
+}
+
+const uint8_t *DisplayManager::getGlyph(uint8_t c)
+{
+  if (glyphCp437 != _cp437)
+  {
+    invalidateGlyphCache();
+    glyphCp437 = _cp437;
+  }
+
+  if (!(glyphValid[c >> 5] & (1UL << (c & 31))))
+  {
+    // Tabel font klasik tidak diekspor Adafruit_GFX, jadi glyph digambar
+    // sekali ke canvas kecil lalu dibaca per kolom
+    GFXcanvas1 canvas(8, 8);
+    canvas.cp437(_cp437);
+    canvas.fillScreen(0);
+    canvas.drawChar(0, 0, c, 1, 1, 1);
+
+    for (int col = 0; col < 5; col++)
+    {
+      uint8_t bits = 0;
+      for (int row = 0; row < 8; row++)
+      {
+        if (canvas.getPixel(col, row))
+          bits |= 1 << row;
+      }
+      glyphCache[c][col] = bits;
+    }
+    glyphValid[c >> 5] |= 1UL << (c & 31);
+  }
+
+  return glyphCache[c];
+}
+
+void DisplayManager::drawCachedChar(int16_t x, int16_t y, uint8_t c)
+{
+  const uint8_t *glyph = getGlyph(c);
+  bool opaque = textbgcolor != textcolor;
+
+  // Sama dengan Adafruit_GFX::drawChar(): 5 kolom glyph lalu kolom
+  // spasi ke-6 yang hanya digambar jika background tidak transparan
+  for (int col = 0; col < 5; col++)
+  {
+    blitColumn(x + col, y, glyph[col], textcolor);
+    if (opaque)
+      blitColumn(x + col, y, ~glyph[col], textbgcolor);
+  }
+  if (opaque)
+    blitColumn(x + 5, y, 0xFF, textbgcolor);
+}
+
+size_t DisplayManager::write(uint8_t c)
+{
+  if (gfxFont || textsize_x != 1 || textsize_y != 1 || !useFastRaster())
+    return Adafruit_SSD1306::write(c);
+
+  if (c == '\n')
+  {
+    cursor_x = 0;
+    cursor_y += 8;
+  }
+  else if (c != '\r')
+  {
+    if (wrap && (cursor_x + 6) > WIDTH)
+    {
+      cursor_x = 0;
+      cursor_y += 8;
+    }
+    drawCachedChar(cursor_x, cursor_y, c);
+    cursor_x += 6;
+  }
+  return 1;
+}
+
+void DisplayManager::drawColumns(int16_t x, int16_t y, const uint8_t *columns, int16_t count, uint16_t color)
+{
+  if (!useFastRaster())
+  {
+    for (int16_t i = 0; i < count; i++)
+    {
+      for (int row = 0; row < 8; row++)
+      {
+        if (columns[i] & (1 << row))
+          drawPixel(x + i, y + row, color);
+      }
+    }
+    return;
+  }
+
+  // Kolom di luar layar dilewati tanpa memanggil blitColumn
+  int16_t first = x < 0 ? -x : 0;
+  int16_t last = min((int)count, WIDTH - x);
+  for (int16_t i = first; i < last; i++)
+  {
+    blitColumn(x + i, y, columns[i], color);
+  }
+}
+
+void DisplayManager::invalidateGlyphCache()
+{
+  memset(glyphValid, 0, sizeof(glyphValid));
+}
+
+void DisplayManager::setFastRaster(bool enabled)
+{
+  fastRaster = enabled;
+}
+
+bool DisplayManager::isFastRaster()
+{
+  return fastRaster;
+}
+
+void DisplayManager::flushTaskEntry(void *param)
+{
+  DisplayManager *self = (DisplayManager *)param;
+
+  TickType_t lastWake = xTaskGetTickCount();
+
+  for (;;)
+  {
+    if (self->grayscale && !NATIVE_GRAY)
+    {
+      self->flushGraySubframe(lastWake);
+      continue;
+    }
+
+    ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+    if (self->grayscale && !NATIVE_GRAY)
+    {
+      // Dibangunkan oleh setGrayscale(), bukan oleh display()
+      lastWake = xTaskGetTickCount();
+      continue;
+    }
+    self->flushFrame(self->frontBuffer, self->frontGrayPlanes, self->frontStartLine);
+    xSemaphoreGive(self->flushIdle);
+  }
+}
+
+bool DisplayManager::setAsyncFlush(bool enabled)
+{
+  if (!enabled)
+  {
+    setGrayscale(false);
+    waitForFlush();
+    asyncFlush = false;
+    return true;
+  }
+
+  if (asyncFlush)
+    return true;
+
+  if (!frontBuffer)
+  {
+    frontBuffer = (uint8_t *)malloc(getBufferSize());
+    if (!frontBuffer)
+    {
+      Log.println("[Display] Async flush: no memory for front buffer");
+      return false;
+    }
+  }
+
+  if (NATIVE_GRAY && !frontGrayPlanes)
+  {
+    frontGrayPlanes = (uint8_t *)malloc(getBufferSize() * 2);
+    if (!frontGrayPlanes)
+    {
+      Log.println("[Display] Async flush: no memory for front gray planes");
+      return false;
+    }
+  }
+
+  if (!flushIdle)
+  {
+    flushIdle = xSemaphoreCreateBinary();
+    xSemaphoreGive(flushIdle);
+  }
+
+  if (!flushTask)
+  {
+    if (xTaskCreate(flushTaskEntry, "oledFlush", FLUSH_TASK_STACK, this,
+                    FLUSH_TASK_PRIORITY, &flushTask) != pdPASS)
+    {
+      flushTask = nullptr;
+      Log.println("[Display] Async flush: task creation failed");
+      return false;
+    }
+  }
+
+  asyncFlush = true;
+  return true;
+}
+
+bool DisplayManager::isAsyncFlush()
+{
+  return asyncFlush;
+}
+
+void DisplayManager::waitForFlush()
+{
+  if (!asyncFlush || !flushIdle)
+    return;
+
+  xSemaphoreTake(flushIdle, portMAX_DELAY);
+  xSemaphoreGive(flushIdle);
+}
+
+bool DisplayManager::setGrayscale(bool enabled)
+{
+  if (enabled == grayscale)
+    return true;
+
+  // Panel 4-bit: plane sudah ada sejak begin(), cukup aktifkan gambar abu-abu
+  if (NATIVE_GRAY)
+  {
+    grayscale = enabled;
+    return grayPlanes != nullptr;
+  }
+
+  if (enabled)
+  {
+    // Subframe dikirim terus-menerus oleh flush task
+    if (!asyncFlush)
+    {
+      Log.println("[Display] Grayscale: async flush required");
+      return false;
+    }
+
+    int size = getBufferSize();
+    if (!grayPlanes)
+      grayPlanes = (uint8_t *)malloc(size * 2);
+    if (!frontGrayPlanes)
+      frontGrayPlanes = (uint8_t *)malloc(size * 2);
+    if (!subframeBuffer)
+      subframeBuffer = (uint8_t *)malloc(size);
+    if (!grayPlanes || !frontGrayPlanes || !subframeBuffer)
+    {
+      Log.println("[Display] Grayscale: no memory for gray planes");
+      return false;
+    }
+    memset(grayPlanes, 0, size * 2);
+    memset(frontGrayPlanes, 0, size * 2);
+  }
+
+  // Buffer plane tetap dialokasikan setelah dimatikan, flush task mungkin
+  // masih mengirim subframe terakhir
+  xSemaphoreTake(flushIdle, portMAX_DELAY);
+  grayscale = enabled;
+  graySubframe = 0;
+  subframeWindowStart = millis();
+  subframeWindowCount = 0;
+  portENTER_CRITICAL(&statsLock);
+  stats.subframeRate = 0;
+  portEXIT_CRITICAL(&statsLock);
+  xSemaphoreGive(flushIdle);
+
+  if (enabled)
+  {
+    xTaskNotifyGive(flushTask);
+  }
+  return true;
+}
+
+bool DisplayManager::isGrayscale()
+{
+  return grayscale;
+}
+
+void DisplayManager::fillRectGray(int16_t x, int16_t y, int16_t w, int16_t h, uint8_t level)
+{
+  if (!grayscale || !grayPlanes || rotation != 0)
+    return;
+
+  fillPlaneRect(grayPlanes, x, y, w, h, (level & 1) ? SSD1306_WHITE : SSD1306_BLACK);
+  fillPlaneRect(grayPlanes + getBufferSize(), x, y, w, h, (level & 2) ? SSD1306_WHITE : SSD1306_BLACK);
+}
+
+void DisplayManager::drawFastVLineGray(int16_t x, int16_t y, int16_t h, uint8_t level)
+{
+  fillRectGray(x, y, 1, h, level);
+}
+
+void DisplayManager::flushGraySubframe(TickType_t &lastWake)
+{
+  int size = getBufferSize();
+
+  // Level L menyala di subframe k jika L > k:
+  // k=0: bit0|bit1, k=1: bit1, k=2: bit0&bit1
+  xSemaphoreTake(flushIdle, portMAX_DELAY);
+  const uint8_t *low = frontGrayPlanes;
+  const uint8_t *high = frontGrayPlanes + size;
+  for (int i = 0; i < size; i++)
+  {
+    uint8_t lit;
+    switch (graySubframe)
+    {
+    case 0:
+      lit = low[i] | high[i];
+      break;
+    case 1:
+      lit = high[i];
+      break;
+    default:
+      lit = low[i] & high[i];
+      break;
+    }
+    subframeBuffer[i] = frontBuffer[i] | lit;
+  }
+  uint8_t line = frontStartLine;
+  xSemaphoreGive(flushIdle);
+
+  // Subframe berurutan hanya berbeda di area abu-abu, jadi flush parsial
+  // biasanya hanya mengirim window kecil
+  flushFrame(subframeBuffer, nullptr, line);
+  graySubframe = (graySubframe + 1) % GRAY_SUBFRAMES;
+
+  subframeWindowCount++;
+  unsigned long now = millis();
+  portENTER_CRITICAL(&statsLock);
+  stats.subframes++;
+  if (now - subframeWindowStart >= 1000)
+  {
+    stats.subframeRate = subframeWindowCount * 1000 / (now - subframeWindowStart);
+    subframeWindowStart = now;
+    subframeWindowCount = 0;
+  }
+  portEXIT_CRITICAL(&statsLock);
+
+  // Rate subframe tetap; jika flush lebih lambat, tetap beri jeda satu tick
+  // agar task lain (loop) tidak kelaparan
+  TickType_t period = pdMS_TO_TICKS(GRAY_SUBFRAME_PERIOD_MS);
+  if (xTaskGetTickCount() - lastWake < period)
+  {
+    vTaskDelayUntil(&lastWake, period);
+  }
+  else
+  {
+    vTaskDelay(1);
+    lastWake = xTaskGetTickCount();
+  }
+}
+
+void DisplayManager::lockBus()
+{
+  if (busMutex)
+  {
+    xSemaphoreTake(busMutex, portMAX_DELAY);
+  }
+}
+
+void DisplayManager::unlockBus()
+{
+  if (busMutex)
+  {
+    xSemaphoreGive(busMutex);
+  }
+}
+
+void DisplayManager::shareBus(DisplayManager &other)
+{
+  if (!other.busMutex)
+  {
+    other.busMutex = xSemaphoreCreateMutex();
+  }
+  busMutex = other.busMutex;
+}
+
+void DisplayManager::setMirror(DisplayManager *target)
+{
+  if (target == this || (target && (target->WIDTH != WIDTH || target->HEIGHT != HEIGHT)))
+  {
+    Log.println("[Display] Mirror: needs another panel of the same size");
+    return;
+  }
+  mirror = target;
+  fadePartner = target;
+  if (mirror)
+  {
+    mirror->invalidate();
+  }
+}
+
+void DisplayManager::setFadePartner(DisplayManager *partner)
+{
+  fadePartner = partner != this ? partner : nullptr;
+}
+
+bool DisplayManager::setVerticalOffset(int rows)
+{
+  // Selama overlay tampil start line dipaksa 0 di display(); pemanggil
+  // diberi tahu agar memakai geser software
+  if (rows != 0 && overlayShown)
+  {
+    startLine = 0;
+    return false;
+  }
+
+  // Pada panel 32 baris, start line tetap berputar di 64 baris GDDRAM
+  // sehingga baris yang terbungkus bukan bagian dari buffer
+  if (rows != 0 && (NATIVE_GRAY || HEIGHT != 64 || abs(rows) >= HEIGHT))
+  {
+    startLine = 0;
+    return false;
+  }
+
+  // Isi di baris y tampil di baris (y - startLine) mod HEIGHT
+  startLine = (HEIGHT - rows) % HEIGHT;
+  return true;
+}
+
+int DisplayManager::getVerticalOffset()
+{
+  if (startLine <= HEIGHT / 2)
+    return -startLine;
+  return HEIGHT - startLine;
+}
+
+void DisplayManager::sendContrast(uint8_t level)
+{
+  ssd1306_command1(SSD1306_SETCONTRAST);
+  ssd1306_command1(level);
+  panelContrast = level;
+}
+
+void DisplayManager::startFadeIn()
+{
+  // Dipanggil dengan bus terkunci
+  if (panelContrast != 0)
+  {
+    sendContrast(0);
+  }
+  if (!panelOn)
+  {
+    ssd1306_command1(SSD1306_DISPLAYON);
+    panelOn = true;
+  }
+  fadeStart = millis();
+  fadingIn = true;
+  fadeInPending = false;
+}
+
+void DisplayManager::fadeOut(unsigned long duration)
+{
+  if (fadePartner)
+  {
+    fadePartner->fadeOut(duration);
+  }
+
+  fadeInPending = false;
+  fadingIn = false;
+
+  if (!panelOn)
+    return;
+
+  fadeOutFrom = panelContrast;
+  fadeOutStart = millis();
+  fadeOutDuration = duration;
+  framePending = false;
+  fadingOut = true;
+}
+
+void DisplayManager::updateFadeOut()
+{
+  unsigned long elapsed = millis() - fadeOutStart;
+  if (elapsed < fadeOutDuration)
+  {
+    int step = elapsed * FADE_OUT_STEPS / fadeOutDuration;
+    uint8_t level = fadeOutFrom * (FADE_OUT_STEPS - step) / FADE_OUT_STEPS;
+    if (level != panelContrast)
+    {
+      lockBus();
+      beginTransfer();
+      sendContrast(level);
+      endTransfer();
+      unlockBus();
+    }
+    return;
+  }
+
+  lockBus();
+  beginTransfer();
+  ssd1306_command1(SSD1306_DISPLAYOFF);
+  endTransfer();
+  unlockBus();
+  panelOn = false;
+  fadingOut = false;
+
+  // Timeout fade-in dihitung sejak panel mati
+  fadeRequested = millis();
+  if (framePending)
+  {
+    framePending = false;
+    display();
+  }
+}
+
+void DisplayManager::fadeIn(unsigned long duration)
+{
+  if (fadePartner)
+  {
+    fadePartner->fadeIn(duration);
+  }
+
+  fadeDuration = duration;
+  fadeRequested = millis();
+  fadeInPending = true;
+}
+
+bool DisplayManager::isFading()
+{
+  return fadingOut || fadeInPending || fadingIn;
+}
+
+void DisplayManager::update()
+{
+  if (fadePartner)
+  {
+    fadePartner->update();
+  }
+
+  if (fadingOut)
+  {
+    updateFadeOut();
+    return;
+  }
+
+  if (fadeInPending && millis() - fadeRequested >= FADE_IN_TIMEOUT)
+  {
+    lockBus();
+    beginTransfer();
+    if (fadeInPending)
+    {
+      startFadeIn();
+    }
+    endTransfer();
+    unlockBus();
+  }
+
+  if (!fadingIn)
+    return;
+
+  unsigned long elapsed = millis() - fadeStart;
+  uint8_t level = contrast;
+  if (elapsed < fadeDuration)
+  {
+    level = (uint32_t)contrast * elapsed / fadeDuration;
+  }
+
+  if (level != panelContrast)
+  {
+    lockBus();
+    beginTransfer();
+    sendContrast(level);
+    endTransfer();
+    unlockBus();
+  }
+
+  if (elapsed >= fadeDuration)
+  {
+    fadingIn = false;
+  }
+}
+
+void DisplayManager::invalidate()
+{
+  shadowValid = false;
+}
+
+void DisplayManager::setPartialFlush(bool enabled)
+{
+  partialFlush = enabled;
+}
+
+bool DisplayManager::isPartialFlush()
+{
+  return partialFlush;
+}
+
+BusCalibration DisplayManager::calibrateBusSpeed()
+{
+  waitForFlush();
+  lockBus();
+
+  BusCalibration best = calibration;
+  best.clock = 0;
+  best.errors = 0;
+
+  // Shadow buffer dipakai sebagai frame uji; isinya tidak lagi cocok
+  // dengan panel sehingga flush berikutnya dibuat penuh
+  uint8_t *testFrame = shadowBuffer ? shadowBuffer : buffer;
+  uint8_t *testPlanes = NATIVE_GRAY ? (shadowBuffer ? shadowBuffer + getBufferSize() : grayPlanes) : nullptr;
+  shadowValid = false;
+
+  // SPI tidak punya ACK untuk mendeteksi clock yang gagal, jadi hanya
+  // clock yang dikonfigurasi yang diukur
+  bool spiBus = isSpi();
+  const uint32_t spiClocks[] = {wireClk};
+  const uint32_t *clocks = spiBus ? spiClocks : CALIBRATION_CLOCKS;
+  int clockCount = spiBus ? 1 : sizeof(CALIBRATION_CLOCKS) / sizeof(CALIBRATION_CLOCKS[0]);
+
+  Log.println(spiBus ? "[Display] Measuring SPI frame time..." : "[Display] Calibrating I2C clock...");
+
+  for (int c = 0; c < clockCount; c++)
+  {
+    uint32_t clock = clocks[c];
+    if (spiBus)
+      beginTransfer();
+    else
+      wire->setClock(clock);
+
+    int errors = 0;
+    unsigned long start = micros();
+    for (int frame = 0; frame < CALIBRATION_FRAMES; frame++)
+    {
+      memset(testFrame, (frame & 1) ? 0xAA : 0x55, getBufferSize());
+      if (testPlanes)
+        memset(testPlanes, (frame & 1) ? 0x55 : 0xAA, getBufferSize() * 2);
+      errors += sendFrame(testFrame, testPlanes);
+    }
+    unsigned long elapsed = micros() - start;
+    if (spiBus)
+      endTransfer();
+
+    unsigned long frameTime = elapsed / CALIBRATION_FRAMES;
+    uint32_t bytesPerSecond = elapsed > 0 ? (uint64_t)getFrameBytes() * CALIBRATION_FRAMES * 1000000UL / elapsed : 0;
+
+    Log.printf("[Display] %lu kHz: %lu us/frame, %lu B/s, %d error(s)\n",
+                  (unsigned long)(clock / 1000), frameTime, (unsigned long)bytesPerSecond, errors);
+
+    if (errors > 0)
+    {
+      best.errors = errors;
+      break;
+    }
+
+    best.clock = clock;
+    best.frameTime = frameTime;
+    best.bytesPerSecond = bytesPerSecond;
+  }
+
+  if (!spiBus)
+    wire->setClock(restoreClk);
+
+  if (best.clock > 0)
+  {
+    wireClk = best.clock;
+  }
+  calibration = best;
+
+  Log.printf("[Display] %s clock: %lu kHz, full frame flush: %lu us (max %lu fps)\n",
+                spiBus ? "SPI" : "I2C", (unsigned long)(wireClk / 1000), calibration.frameTime,
+                calibration.frameTime > 0 ? 1000000UL / calibration.frameTime : 0UL);
+
+  unlockBus();
+  return calibration;
+}
+
+BusCalibration DisplayManager::getBusCalibration()
+{
+  return calibration;
+}
+
+void DisplayManager::setBusClock(uint32_t clock)
+{
+  waitForFlush();
+  wireClk = clock;
+  if (isSpi())
+  {
+    spiSettings = SPISettings(clock, MSBFIRST, SPI_MODE0);
+  }
+}
+
+uint32_t DisplayManager::getBusClock()
+{
+  return wireClk;
+}
+
+FlushStats DisplayManager::getFlushStats()
+{
+  portENTER_CRITICAL(&statsLock);
+  FlushStats copy = stats;
+  portEXIT_CRITICAL(&statsLock);
+  return copy;
+}
+
+void DisplayManager::resetFlushStats()
+{
+  portENTER_CRITICAL(&statsLock);
+  stats = FlushStats();
+  portEXIT_CRITICAL(&statsLock);
+}
@@ -0,0 +1,291 @@
+#ifndef DISPLAY_MANAGER_H
+#define DISPLAY_MANAGER_H
+
+#include <Arduino.h>
+#include <Wire.h>
+#include <SPI.h>
+#include <Adafruit_GFX.h>
+#include <Adafruit_SSD1306.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+#include <freertos/semphr.h>
+#include <functional>
+#include "PanelLayout.h"
+
+struct FlushStats
+{
+  unsigned long frames;        // jumlah flush yang diminta
+  unsigned long fullFlushes;   // flush yang mengirim seluruh buffer
+  unsigned long windowsSent;   // jumlah window page/kolom yang dikirim
+  unsigned long bytesSent;     // byte data GDDRAM yang dikirim
+  unsigned long lastFlushTime; // durasi transfer terakhir (us)
+  unsigned long waitTime;      // total waktu render menunggu flush sebelumnya (us)
+  unsigned long startLineSet;  // perintah start line yang dikirim (geser vertikal hardware)
+  unsigned long subframes;     // subframe grayscale yang dikirim
+  unsigned long subframeRate;  // subframe per detik, diukur tiap 1 detik
+};
+
+struct BusCalibration
+{
+  uint32_t clock;          // clock I2C tertinggi yang stabil (Hz)
+  unsigned long frameTime; // waktu kirim satu frame penuh pada clock tersebut (us)
+  uint32_t bytesPerSecond;
+  int errors; // NACK pada clock pertama yang gagal, 0 jika semua stabil
+};
+
+class DisplayManager : public Adafruit_SSD1306
+{
+private:
+  // Salinan isi GDDRAM panel setelah transfer terakhir, dipakai untuk
+  // mencari page dan rentang kolom yang berubah
+  uint8_t *shadowBuffer;
+  volatile bool shadowValid;
+  bool partialFlush;
+
+  // Front buffer: frame yang sedang dikirim oleh flush task, sementara
+  // frame berikutnya digambar ke buffer milik Adafruit_SSD1306
+  uint8_t *frontBuffer;
+  bool asyncFlush;
+  TaskHandle_t flushTask;
+  SemaphoreHandle_t flushIdle;
+  SemaphoreHandle_t busMutex;
+
+  // Primitive isi yang menulis mask byte langsung ke layout page SSD1306.
+  // Jika false (atau rotasi != 0) dipakai jalur bawaan Adafruit GFX.
+  bool fastRaster;
+
+  // Start line GDDRAM (perintah 0x40 | n) untuk menggeser isi panel secara
+  // vertikal tanpa mengirim ulang frame. Diterapkan bersama frame berikutnya.
+  uint8_t startLine;      // diminta untuk frame berikutnya
+  uint8_t frontStartLine; // milik frame di front buffer
+  uint8_t panelStartLine; // yang terakhir dikirim ke panel
+
+  // Transisi layar lewat register contrast (0x81) dan display on/off,
+  // tanpa merender frame perantara
+  uint8_t panelContrast;
+  volatile bool panelOn;
+  volatile bool fadeInPending; // panel dinyalakan bersama frame berikutnya
+  volatile bool fadingIn;
+  unsigned long fadeRequested;
+  unsigned long fadeStart;
+  unsigned long fadeDuration;
+  // Fade-out dijalankan oleh update(); frame layar baru ditahan sampai
+  // panel mati agar layar lama yang meredup
+  volatile bool fadingOut;
+  bool framePending;
+  uint8_t fadeOutFrom;
+  unsigned long fadeOutStart;
+  unsigned long fadeOutDuration;
+
+  // Mode grayscale: dua plane bit level abu-abu (0-3) di atas buffer mono.
+  // Flush task mengirim GRAY_SUBFRAMES subframe 1-bit bergantian, piksel
+  // level L menyala di L dari 3 subframe. Piksel mono putih selalu menyala.
+  volatile bool grayscale;
+  uint8_t *grayPlanes;      // plane bit0 lalu plane bit1, masing-masing seukuran buffer
+  uint8_t *frontGrayPlanes; // salinan milik flush task
+  uint8_t *subframeBuffer;
+  uint8_t graySubframe;
+  unsigned long subframeWindowStart;
+  unsigned long subframeWindowCount;
+
+  // SSD1327 (PANEL_SSD1327): panel grayscale 4-bit. Gambar tetap ke buffer
+  // page + plane abu-abu; hanya window yang berubah yang dikonversi ke
+  // 4bpp saat flush. Plane selalu dialokasikan, tanpa subframe.
+  static const bool NATIVE_GRAY = PANEL_SSD1327;
+
+  // Glyph font klasik 5x8 dalam bentuk byte kolom (LSB = baris atas), sama
+  // dengan packing page SSD1306. Diisi saat glyph pertama kali dipakai.
+  uint8_t glyphCache[256][5];
+  uint32_t glyphValid[8];
+  bool glyphCp437;
+
+  // Snapshot buffer (dan plane abu-abu) layar yang ditinggalkan sementara,
+  // dikembalikan saat layar itu aktif lagi tanpa render dari kosong
+  static const int SNAPSHOT_SLOTS = 2;
+  uint8_t *snapshots[SNAPSHOT_SLOTS];
+  int snapshotSizes[SNAPSHOT_SLOTS];
+  bool snapshotValid[SNAPSHOT_SLOTS];
+
+  // Layer di atas layar aktif, digambar ke buffer tepat sebelum flush.
+  // underlay menyimpan isi buffer di bawahnya selama frame diserahkan.
+  std::function<bool()> overlay;
+  uint8_t *underlay;
+  bool overlayShown; // overlay ikut di frame terakhir
+
+  // Panel kedua yang menerima salinan setiap frame (DUAL_PANEL_MIRROR)
+  DisplayManager *mirror;
+  // Panel yang ikut fade dan update() panel ini (mirror atau panel kanan split)
+  DisplayManager *fadePartner;
+
+  // Pengamat frame final (setelah overlay), mis. stream mirroring
+  std::function<void(const uint8_t *, uint8_t)> frameListener;
+
+  // stats dibaca dan direset dari loop() sementara flush task menulisnya,
+  // jadi hanya diakses di dalam critical section statsLock. Hitungan satu
+  // flush dikumpulkan di flushCounts (dilindungi busMutex) lalu digabung.
+  FlushStats stats;
+  FlushStats flushCounts;
+  portMUX_TYPE statsLock;
+  BusCalibration calibration;
+
+  // Celah kolom yang tidak berubah di bawah nilai ini tetap ikut dikirim,
+  // karena lebih murah daripada membuka window baru (6 byte command)
+  static const int WINDOW_MERGE_GAP = 8;
+  static const uint32_t FLUSH_TASK_STACK = 3072;
+  static const UBaseType_t FLUSH_TASK_PRIORITY = 2;
+  static const int CALIBRATION_FRAMES = 4;
+  static const int FADE_OUT_STEPS = 8;
+  static const int GRAY_SUBFRAMES = 3;
+  static const uint32_t GRAY_SUBFRAME_PERIOD_MS = 5;
+  // Jika layar baru tidak mengirim frame, panel tetap dinyalakan setelah ini
+  static const unsigned long FADE_IN_TIMEOUT = 300;
+
+  bool useFastRaster();
+  void fillPageRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color);
+  void fillPlaneRect(uint8_t *plane, int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color);
+  void blitColumn(int16_t x, int16_t y, uint8_t bits, uint16_t color);
+  void drawCachedChar(int16_t x, int16_t y, uint8_t c);
+
+  int getPageCount();
+  int getBufferSize();
+  int getFrameBytes();
+  bool beginSSD1327(uint8_t i2caddr);
+  void flushFrame(const uint8_t *frame, const uint8_t *planes, uint8_t line);
+  void flushFull(const uint8_t *frame, const uint8_t *planes);
+  void flushDirty(const uint8_t *frame);
+  void flushDirtyGray(const uint8_t *frame, const uint8_t *planes);
+  int sendFrame(const uint8_t *frame, const uint8_t *planes);
+  int sendWindow(uint8_t pageStart, uint8_t pageEnd, uint8_t colStart, uint8_t colEnd, const uint8_t *data);
+  int sendGrayWindow(uint8_t pageStart, uint8_t pageEnd, uint8_t colStart, uint8_t colEnd,
+                     const uint8_t *frame, const uint8_t *planes);
+  void sendContrast(uint8_t level);
+  void startFadeIn();
+  void updateFadeOut();
+  bool drawOverlay();
+  void submitFrame();
+  void flushGraySubframe(TickType_t &lastWake);
+
+  void init();
+  void beginTransfer();
+  void endTransfer();
+  int sendData(const uint8_t *data, int length);
+
+  static void flushTaskEntry(void *param);
+
+public:
+  DisplayManager(uint8_t w, uint8_t h, TwoWire *twi = &Wire, int8_t rst_pin = -1);
+  // Modul SSD1306 SPI (4-wire): data frame dikirim per window dalam satu
+  // burst SPI, command tetap lewat jalur Adafruit
+  DisplayManager(uint8_t w, uint8_t h, SPIClass *spi, int8_t dc_pin, int8_t rst_pin, int8_t cs_pin,
+                 uint32_t bitrate = 10000000UL);
+  ~DisplayManager();
+
+  bool begin(uint8_t switchvcc = SSD1306_SWITCHCAPVCC, uint8_t i2caddr = 0);
+
+  // Juga mengosongkan plane grayscale
+  void clearDisplay();
+
+  // Menggantikan Adafruit_SSD1306::display(): hanya page/kolom yang berubah
+  // yang dikirim ke panel jika partial flush aktif. Dalam mode async,
+  // fungsi ini hanya menyerahkan frame ke flush task lalu kembali.
+  void display();
+
+  // Simpan isi buffer saat ini ke slot (0..SNAPSHOT_SLOTS-1). restoreSnapshot()
+  // menyalinnya kembali ke buffer dan memakai snapshot sekali saja; false jika
+  // slot kosong sehingga layar harus menggambar sendiri.
+  bool saveSnapshot(int slot);
+  bool restoreSnapshot(int slot);
+  void discardSnapshots();
+
+  // Callback yang menggambar overlay (mis. toast) di atas setiap frame
+  // yang dikirim lewat display(); nullptr untuk melepas. Jika callback
+  // menggambar (return true), geser vertikal hardware tidak dipakai untuk
+  // frame itu karena overlay akan ikut tergeser dan terbungkus. Setelah
+  // frame diserahkan, buffer dikembalikan ke isi tanpa overlay.
+  void setOverlay(std::function<bool()> drawOverlay);
+
+  // Dipanggil dari display() dengan buffer page dan start line frame yang
+  // akan dikirim. Harus cepat dan tidak menyimpan pointer buffer.
+  void setFrameListener(std::function<void(const uint8_t *frame, uint8_t startLine)> listener);
+
+  void drawFastHLine(int16_t x, int16_t y, int16_t w, uint16_t color) override;
+  void drawFastVLine(int16_t x, int16_t y, int16_t h, uint16_t color) override;
+  void fillRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color) override;
+  void fillScreen(uint16_t color) override;
+
+  // Teks font klasik ukuran 1 digambar dari glyph cache; font GFX, ukuran
+  // lain atau rotasi != 0 tetap lewat Adafruit_GFX::write()
+  using Adafruit_SSD1306::write;
+  size_t write(uint8_t c) override;
+  void invalidateGlyphCache();
+  const uint8_t *getGlyph(uint8_t c);
+
+  // Blit byte kolom (LSB = baris y) selebar count piksel, dipakai untuk
+  // bitmap yang sudah dalam layout page seperti glyph dan strip teks
+  void drawColumns(int16_t x, int16_t y, const uint8_t *columns, int16_t count, uint16_t color);
+
+  void setFastRaster(bool enabled);
+  bool isFastRaster();
+
+  // Geser tampilan sebanyak rows baris (positif = ke bawah) lewat start
+  // line. Baris yang terbungkus ke sisi lain layar harus kosong, ini
+  // tanggung jawab pemanggil. Hanya untuk panel 64 baris, false jika tidak
+  // atau selama overlay tampil (start line overlay selalu 0).
+  bool setVerticalOffset(int rows);
+  int getVerticalOffset();
+
+  // Keduanya langsung kembali; contrast diubah oleh update() yang dipanggil
+  // dari loop. fadeOut() meredupkan lalu mematikan panel, frame yang
+  // dikirim selama itu ditahan dan dikirim setelah panel mati. Setelah
+  // fadeIn() panel menyala bersama frame berikutnya.
+  void fadeOut(unsigned long duration);
+  void fadeIn(unsigned long duration);
+  bool isFading();
+  void update();
+
+  void invalidate();
+  void setPartialFlush(bool enabled);
+  bool isPartialFlush();
+
+  bool setAsyncFlush(bool enabled);
+  bool isAsyncFlush();
+  void waitForFlush();
+
+  // Grayscale temporal dithering, butuh async flush. Level 0 (mati) sampai
+  // 3 (putih penuh); gambar abu-abu tanpa efek jika mode tidak aktif.
+  // Pada SSD1327 level dikirim langsung sebagai piksel 4-bit.
+  bool setGrayscale(bool enabled);
+  bool isGrayscale();
+  void fillRectGray(int16_t x, int16_t y, int16_t w, int16_t h, uint8_t level);
+  void drawFastVLineGray(int16_t x, int16_t y, int16_t h, uint8_t level);
+
+  // Dipakai oleh kode lain yang mengakses bus I2C display secara langsung
+  void lockBus();
+  void unlockBus();
+
+  // Panel lain di bus I2C yang sama: pakai mutex bus miliknya sehingga
+  // transfer kedua flush task bergantian. Panggil sebelum begin().
+  void shareBus(DisplayManager &other);
+
+  // Setiap frame (buffer, plane abu-abu dan start line) juga diserahkan ke
+  // panel mirror, yang melacak page berubah dan mengirimnya sendiri.
+  // Rasterisasi hanya sekali; fade ikut diteruskan. nullptr = lepas.
+  void setMirror(DisplayManager *target);
+  // Panel lain yang meredup dan menyala bersama panel ini, tanpa salinan
+  // frame (mis. panel kanan DUAL_PANEL_SPLIT). update() ikut diteruskan.
+  void setFadePartner(DisplayManager *partner);
+
+  // Mencoba beberapa clock I2C dengan frame uji, lalu memakai clock
+  // tertinggi yang semua byte-nya di-ACK oleh panel. Di SPI hanya
+  // mengukur waktu frame pada clock saat ini.
+  BusCalibration calibrateBusSpeed();
+  BusCalibration getBusCalibration();
+  void setBusClock(uint32_t clock);
+  uint32_t getBusClock();
+  bool isSpi();
+
+  FlushStats getFlushStats();
+  void resetFlushStats();
+};
+
+#endif
@@ -0,0 +1,131 @@
+#include "DualDisplay.h"
+
+DualDisplay::DualDisplay(DisplayManager &leftPanel, DisplayManager &rightPanel)
+    : Adafruit_GFX(leftPanel.width() + rightPanel.width(), leftPanel.height()),
+      left(leftPanel),
+      right(rightPanel),
+      composite(nullptr)
+{
+}
+
+DualDisplay::~DualDisplay()
+{
+  free(composite);
+}
+
+DisplayManager &DualDisplay::panelAt(int16_t x)
+{
+  return x < left.width() ? left : right;
+}
+
+void DualDisplay::drawPixel(int16_t x, int16_t y, uint16_t color)
+{
+  if (x < 0 || x >= WIDTH)
+    return;
+  if (x < left.width())
+    left.drawPixel(x, y, color);
+  else
+    right.drawPixel(x - left.width(), y, color);
+}
+
+void DualDisplay::drawFastHLine(int16_t x, int16_t y, int16_t w, uint16_t color)
+{
+  fillRect(x, y, w, 1, color);
+}
+
+void DualDisplay::drawFastVLine(int16_t x, int16_t y, int16_t h, uint16_t color)
+{
+  if (x < 0 || x >= WIDTH)
+    return;
+  if (x < left.width())
+    left.drawFastVLine(x, y, h, color);
+  else
+    right.drawFastVLine(x - left.width(), y, h, color);
+}
+
+void DualDisplay::fillRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color)
+{
+  // Rect yang melintasi sambungan dipotong menjadi dua
+  int16_t seam = left.width();
+  if (x < seam)
+  {
+    int16_t leftW = min((int16_t)(x + w), seam) - x;
+    left.fillRect(x, y, leftW, h, color);
+  }
+  if (x + w > seam)
+  {
+    int16_t rightX = max(x, seam);
+    right.fillRect(rightX - seam, y, x + w - rightX, h, color);
+  }
+}
+
+void DualDisplay::fillScreen(uint16_t color)
+{
+  left.fillScreen(color);
+  right.fillScreen(color);
+}
+
+void DualDisplay::clearDisplay()
+{
+  left.clearDisplay();
+  right.clearDisplay();
+}
+
+void DualDisplay::display()
+{
+  // Masing-masing hanya menunggu flush sebelumnya di panelnya sendiri
+  left.display();
+  right.display();
+}
+
+void DualDisplay::waitForFlush()
+{
+  left.waitForFlush();
+  right.waitForFlush();
+}
+
+uint8_t *DualDisplay::getBuffer()
+{
+  int pages = (HEIGHT + 7) / 8;
+  if (!composite)
+  {
+    composite = (uint8_t *)malloc(WIDTH * pages);
+    if (!composite)
+      return nullptr;
+  }
+
+  int leftW = left.width();
+  int rightW = right.width();
+  for (int page = 0; page < pages; page++)
+  {
+    memcpy(composite + page * WIDTH, left.getBuffer() + page * leftW, leftW);
+    memcpy(composite + page * WIDTH + leftW, right.getBuffer() + page * rightW, rightW);
+  }
+  return composite;
+}
+
+bool DualDisplay::setVerticalOffset(int rows)
+{
+  bool ok = left.setVerticalOffset(rows);
+  if (!right.setVerticalOffset(ok ? rows : 0))
+  {
+    // Kedua panel harus bergeser bersama, jika tidak keduanya tetap di 0
+    left.setVerticalOffset(0);
+    return rows == 0;
+  }
+  return ok;
+}
+
+void DualDisplay::drawFastVLineGray(int16_t x, int16_t y, int16_t h, uint8_t level)
+{
+  if (x < 0 || x >= WIDTH)
+    return;
+  panelAt(x).drawFastVLineGray(x < left.width() ? x : x - left.width(), y, h, level);
+}
+
+void DualDisplay::releaseRight()
+{
+  right.setVerticalOffset(0);
+  right.clearDisplay();
+  right.display();
+}
@@ -0,0 +1,47 @@
+#ifndef DUAL_DISPLAY_H
+#define DUAL_DISPLAY_H
+
+#include <Arduino.h>
+#include <Adafruit_GFX.h>
+#include "DisplayManager.h"
+
+// Satu kanvas logis selebar dua panel (mis. 256x64) di atas dua
+// DisplayManager pada bus I2C yang sama. Gambar diteruskan ke panel kiri
+// atau kanan sesuai x; tiap panel tetap punya buffer, dirty tracking dan
+// flush task sendiri sehingga transfer keduanya bergantian di bus
+// sementara frame berikutnya dirender.
+class DualDisplay : public Adafruit_GFX
+{
+private:
+  DisplayManager &left;
+  DisplayManager &right;
+
+  // Salinan gabungan buffer kedua panel dalam layout page, hanya dibuat
+  // saat getBuffer() dipanggil (verifikasi renderer)
+  uint8_t *composite;
+
+  DisplayManager &panelAt(int16_t x);
+
+public:
+  DualDisplay(DisplayManager &leftPanel, DisplayManager &rightPanel);
+  ~DualDisplay();
+
+  void drawPixel(int16_t x, int16_t y, uint16_t color) override;
+  void drawFastHLine(int16_t x, int16_t y, int16_t w, uint16_t color) override;
+  void drawFastVLine(int16_t x, int16_t y, int16_t h, uint16_t color) override;
+  void fillRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color) override;
+  void fillScreen(uint16_t color) override;
+
+  void clearDisplay();
+  void display();
+  void waitForFlush();
+  uint8_t *getBuffer();
+
+  bool setVerticalOffset(int rows);
+  void drawFastVLineGray(int16_t x, int16_t y, int16_t h, uint8_t level);
+
+  // Kosongkan panel kanan saat layar lain hanya memakai panel kiri
+  void releaseRight();
+};
+
+#endif
@@ -23,13 +23,11 @@
  */
 
 #include <Arduino.h>
+#include <functional>
+#include "SerialLog.h"
 #ifndef _FLUXGARAGE_ROBOEYES_H
 #define _FLUXGARAGE_ROBOEYES_H
 
-// Display colors
-uint8_t BGCOLOR = 0;   // background and overlays
-uint8_t MAINCOLOR = 1; // drawings
-
 // For mood type switch
 #define DEFAULT 0
 #define TIRED 1
@@ -51,9 +49,29 @@ uint8_t MAINCOLOR = 1; // drawings
 #define NORTH_WEST 8 // north-west, top left
 // for middle center set "DEFAULT"
 
+// For switch "tween mode"
+#define TWEEN_HALVING 0 // halve the distance to the target every drawn frame (frame rate dependent)
+#define TWEEN_TIMED 1   // time based tweens with a duration and easing curve per property group
+
+// Property groups for time based tweens
+#define TWEEN_SIZE 0     // eye width and height, blinking
+#define TWEEN_POSITION 1 // eye position and space between eyes
+#define TWEEN_RADIUS 2   // border radius
+#define TWEEN_LIDS 3     // tired, angry and happy eyelids
+
+// Easing curves for time based tweens
+#define EASE_LINEAR 0
+#define EASE_IN 1     // quadratic
+#define EASE_OUT 2    // quadratic
+#define EASE_IN_OUT 3 // quadratic
+#define EASE_OUT_CUBIC 4
+
 // Constructor: takes a reference to the active Adafruit display object (e.g., Adafruit_SSD1327)
 // Eg: roboEyes<Adafruit_SSD1327> = eyes(display);
-template <typename AdafruitDisplay>
+// Optionally pass the panel size as template arguments, e.g. RoboEyes<Adafruit_SSD1306, 128, 64>,
+// to turn screen size, default positions and constraints into compile time constants.
+// The width and height passed to begin() are ignored in that case.
+template <typename AdafruitDisplay, int FixedWidth = 0, int FixedHeight = 0>
 class RoboEyes
 {
 private:
@@ -63,9 +81,15 @@ public:
   // Reference to Adafruit display object
   AdafruitDisplay *display;
 
+  // Display colors. Static template members instead of globals, so the header
+  // can be included from more than one translation unit
+  static uint8_t BGCOLOR;   // background and overlays
+  static uint8_t MAINCOLOR; // drawings
+
   // For general setup - screen size and max. frame rate
-  int screenWidth = 128;      // OLED display width, in pixels
-  int screenHeight = 64;      // OLED display height, in pixels
+  static constexpr bool fixedGeometry = FixedWidth > 0 && FixedHeight > 0;
+  int screenWidth = fixedGeometry ? FixedWidth : 128;  // OLED display width, in pixels
+  int screenHeight = fixedGeometry ? FixedHeight : 64; // OLED display height, in pixels
   int frameInterval = 20;     // default value for 50 frames per second (1000/50 = 20 milliseconds)
   unsigned long fpsTimer = 0; // for timing the frames per second
 
@@ -78,6 +102,13 @@ public:
   bool eyeL_open = 0; // left eye opened or closed?
   bool eyeR_open = 0; // right eye opened or closed?
 
+  // For choosing the eye renderer
+  bool analyticRenderer = 0; // if true, use the single pass analytic renderer whenever possible
+
+  // Optional soft eye edges: draws a dimmed 1 pixel outline run (x, y, height) around the eyes,
+  // e.g. on a grayscale capable display. Only used by the analytic renderer.
+  std::function<void(int, int, int)> softEdgeHandler = nullptr;
+
   //*********************************************************************************************
   //  Eyes Geometry
   //*********************************************************************************************
@@ -108,9 +139,14 @@ public:
   byte eyeRborderRadiusCurrent = eyeRborderRadiusDefault;
   byte eyeRborderRadiusNext = eyeRborderRadiusDefault;
 
+  // Space between eyes (declared before the coordinates, which are initialized from it)
+  int spaceBetweenDefault = 10;
+  int spaceBetweenCurrent = spaceBetweenDefault;
+  int spaceBetweenNext = 10;
+
   // EYE LEFT - Coordinates
-  int eyeLxDefault = ((screenWidth) - (eyeLwidthDefault + spaceBetweenDefault + eyeRwidthDefault)) / 2;
-  int eyeLyDefault = ((screenHeight - eyeLheightDefault) / 2);
+  int eyeLxDefault = ((getScreenWidth()) - (eyeLwidthDefault + spaceBetweenDefault + eyeRwidthDefault)) / 2;
+  int eyeLyDefault = ((getScreenHeight() - eyeLheightDefault) / 2);
   int eyeLx = eyeLxDefault;
   int eyeLy = eyeLyDefault;
   int eyeLxNext = eyeLx;
@@ -135,10 +171,40 @@ public:
   byte eyelidsHappyBottomOffsetMax = (eyeLheightDefault / 2) + 3;
   byte eyelidsHappyBottomOffset = 0;
   byte eyelidsHappyBottomOffsetNext = 0;
-  // Space between eyes
-  int spaceBetweenDefault = 10;
-  int spaceBetweenCurrent = spaceBetweenDefault;
-  int spaceBetweenNext = 10;
+
+  //*********************************************************************************************
+  //  Tweening
+  //*********************************************************************************************
+
+  byte tweenMode = TWEEN_HALVING;
+
+  // Time based tween of one property, value in 24.8 fixed point
+  struct Tween
+  {
+    int32_t from;
+    int32_t value;
+    int target;
+    unsigned long start;
+    bool active;
+  };
+
+  struct TweenCurve
+  {
+    unsigned int duration; // in milliseconds
+    byte easing;
+  };
+
+  // Defaults roughly match the halving tweens at 50 frames per second
+  TweenCurve tweenCurves[4] = {
+      {100, EASE_IN_OUT},    // TWEEN_SIZE
+      {250, EASE_OUT_CUBIC}, // TWEEN_POSITION
+      {150, EASE_OUT},       // TWEEN_RADIUS
+      {150, EASE_OUT}};      // TWEEN_LIDS
+
+  Tween tweenLwidth, tweenLheight, tweenRwidth, tweenRheight;
+  Tween tweenX, tweenY, tweenSpace;
+  Tween tweenLradius, tweenRradius;
+  Tween tweenTired, tweenAngry, tweenHappy;
 
   //*********************************************************************************************
   //  Macro Animations
@@ -153,6 +219,9 @@ public:
   bool vFlicker = 0;
   bool vFlickerAlternate = 0;
   byte vFlickerAmplitude = 10;
+  // Optional hardware vertical shift (e.g. display start line), returns false if not possible
+  std::function<bool(int)> verticalShiftHandler = nullptr;
+  int hardwareVShift = 0; // offset currently applied by the handler
 
   // Animation - auto blinking
   bool autoblinker = 0;           // activate auto blink animation
@@ -215,8 +284,11 @@ public:
   // Startup RoboEyes with defined screen-width, screen-height and max. frames per second
   void begin(int width, int height, byte frameRate)
   {
-    screenWidth = width;     // OLED display width, in pixels
-    screenHeight = height;   // OLED display height, in pixels
+    if (!fixedGeometry)
+    {
+      screenWidth = width;   // OLED display width, in pixels
+      screenHeight = height; // OLED display height, in pixels
+    }
     display->clearDisplay(); // clear the display buffer
     display->display();      // show empty screen
     eyeLheightCurrent = 1;   // start with closed eyes
@@ -422,25 +494,111 @@ public:
     vFlicker = flickerBit; // turn flicker on or off
   }
 
+  // Set vertical shift handler - vertical flicker moves the whole picture in hardware instead of redrawing the eyes
+  void setVerticalShiftHandler(std::function<bool(int)> handler)
+  {
+    verticalShiftHandler = handler;
+  }
+
   void setSweat(bool sweatBit)
   {
     sweat = sweatBit; // turn sweat on or off
   }
 
+  // Set analytic renderer - draw eyes and eyelids in a single pass instead of overdrawing primitives
+  void setAnalyticRenderer(bool analyticBit)
+  {
+    analyticRenderer = analyticBit;
+  }
+
+  // Set tween mode - TWEEN_HALVING (original behaviour) or TWEEN_TIMED (independent of frame rate)
+  void setTweenMode(byte mode)
+  {
+    if (mode == TWEEN_TIMED && tweenMode != TWEEN_TIMED)
+    {
+      // Start all tweens from the values currently on screen
+      resetTween(tweenLwidth, eyeLwidthCurrent);
+      resetTween(tweenLheight, eyeLheightCurrent);
+      resetTween(tweenRwidth, eyeRwidthCurrent);
+      resetTween(tweenRheight, eyeRheightCurrent);
+      resetTween(tweenX, eyeLx);
+      resetTween(tweenY, eyeLy - (eyeLheightDefault - eyeLheightCurrent) / 2);
+      resetTween(tweenSpace, spaceBetweenCurrent);
+      resetTween(tweenLradius, eyeLborderRadiusCurrent);
+      resetTween(tweenRradius, eyeRborderRadiusCurrent);
+      resetTween(tweenTired, eyelidsTiredHeight);
+      resetTween(tweenAngry, eyelidsAngryHeight);
+      resetTween(tweenHappy, eyelidsHappyBottomOffset);
+    }
+    tweenMode = mode;
+  }
+
+  // Set duration (ms) and easing curve of a property group, e.g. setTweenCurve(TWEEN_SIZE, 80, EASE_IN_OUT)
+  void setTweenCurve(byte group, unsigned int duration, byte easing)
+  {
+    if (group > TWEEN_LIDS)
+      return;
+    tweenCurves[group].duration = duration;
+    tweenCurves[group].easing = easing;
+  }
+
+  // Set frame skipping - skip render and flush while the eyes are settled and nothing animates
+  void setFrameSkipping(bool skippingBit)
+  {
+    frameSkipping = skippingBit;
+    lastFrameValid = 0;
+  }
+
+  // Force the next frame to be drawn, e.g. after something else has drawn on the display
+  void invalidateFrame()
+  {
+    lastFrameValid = 0;
+  }
+
+  unsigned long getFramesDrawn()
+  {
+    return framesDrawn;
+  }
+
+  unsigned long getFramesSkipped()
+  {
+    return framesSkipped;
+  }
+
+  // Set soft edge handler - called with vertical runs of the outline around the eyes
+  void setSoftEdges(std::function<void(int, int, int)> handler)
+  {
+    softEdgeHandler = handler;
+  }
+
   //*********************************************************************************************
   //  GETTERS METHODS
   //*********************************************************************************************
 
+  // Screen size, folded to a constant for fixed geometry instantiations
+  int getScreenWidth() const
+  {
+    return fixedGeometry ? FixedWidth : screenWidth;
+  }
+
+  int getScreenHeight() const
+  {
+    return fixedGeometry ? FixedHeight : screenHeight;
+  }
+
   // Returns the max x position for left eye
   int getScreenConstraint_X()
   {
-    return screenWidth - eyeLwidthCurrent - spaceBetweenCurrent - eyeRwidthCurrent;
+    // Cyclops: the right eye and the space between are only zeroed while drawing
+    if (cyclops)
+      return getScreenWidth() - eyeLwidthCurrent;
+    return getScreenWidth() - eyeLwidthCurrent - spaceBetweenCurrent - eyeRwidthCurrent;
   }
 
   // Returns the max y position for left eye
   int getScreenConstraint_Y()
   {
-    return screenHeight - eyeLheightDefault; // using default height here, because height will vary when blinking and in curious mode
+    return getScreenHeight() - eyeLheightDefault; // using default height here, because height will vary when blinking and in curious mode
   }
 
   //*********************************************************************************************
@@ -547,7 +705,7 @@ public:
       {
         eyeLheightOffset = 0;
       } // left eye
-      if (eyeRxNext >= screenWidth - eyeRwidthCurrent - 10)
+      if (eyeRxNext >= getScreenWidth() - eyeRwidthCurrent - 10)
       {
         eyeRheightOffset = 8;
       }
@@ -562,14 +720,21 @@ public:
       eyeRheightOffset = 0; // reset height offset for right eye
     }
 
-    // Left eye height
-    eyeLheightCurrent = (eyeLheightCurrent + eyeLheightNext + eyeLheightOffset) / 2;
-    eyeLy += ((eyeLheightDefault - eyeLheightCurrent) / 2); // vertical centering of eye when closing
-    eyeLy -= eyeLheightOffset / 2;
-    // Right eye height
-    eyeRheightCurrent = (eyeRheightCurrent + eyeRheightNext + eyeRheightOffset) / 2;
-    eyeRy += (eyeRheightDefault - eyeRheightCurrent) / 2; // vertical centering of eye when closing
-    eyeRy -= eyeRheightOffset / 2;
+    if (tweenMode == TWEEN_TIMED)
+    {
+      updateTimedTweens(); // sizes, position, space between and border radius
+    }
+    else
+    {
+      // Left eye height
+      eyeLheightCurrent = (eyeLheightCurrent + eyeLheightNext + eyeLheightOffset) / 2;
+      eyeLy += ((eyeLheightDefault - eyeLheightCurrent) / 2); // vertical centering of eye when closing
+      eyeLy -= eyeLheightOffset / 2;
+      // Right eye height
+      eyeRheightCurrent = (eyeRheightCurrent + eyeRheightNext + eyeRheightOffset) / 2;
+      eyeRy += (eyeRheightDefault - eyeRheightCurrent) / 2; // vertical centering of eye when closing
+      eyeRy -= eyeRheightOffset / 2;
+    }
 
     // Open eyes again after closing them
     if (eyeL_open)
@@ -587,27 +752,30 @@ public:
       }
     }
 
-    // Left eye width
-    eyeLwidthCurrent = (eyeLwidthCurrent + eyeLwidthNext) / 2;
-    // Right eye width
-    eyeRwidthCurrent = (eyeRwidthCurrent + eyeRwidthNext) / 2;
-
-    // Space between eyes
-    spaceBetweenCurrent = (spaceBetweenCurrent + spaceBetweenNext) / 2;
-
-    // Left eye coordinates
-    eyeLx = (eyeLx + eyeLxNext) / 2;
-    eyeLy = (eyeLy + eyeLyNext) / 2;
-    // Right eye coordinates
-    eyeRxNext = eyeLxNext + eyeLwidthCurrent + spaceBetweenCurrent; // right eye's x position depends on left eyes position + the space between
-    eyeRyNext = eyeLyNext;                                          // right eye's y position should be the same as for the left eye
-    eyeRx = (eyeRx + eyeRxNext) / 2;
-    eyeRy = (eyeRy + eyeRyNext) / 2;
-
-    // Left eye border radius
-    eyeLborderRadiusCurrent = (eyeLborderRadiusCurrent + eyeLborderRadiusNext) / 2;
-    // Right eye border radius
-    eyeRborderRadiusCurrent = (eyeRborderRadiusCurrent + eyeRborderRadiusNext) / 2;
+    if (tweenMode != TWEEN_TIMED)
+    {
+      // Left eye width
+      eyeLwidthCurrent = (eyeLwidthCurrent + eyeLwidthNext) / 2;
+      // Right eye width
+      eyeRwidthCurrent = (eyeRwidthCurrent + eyeRwidthNext) / 2;
+
+      // Space between eyes
+      spaceBetweenCurrent = (spaceBetweenCurrent + spaceBetweenNext) / 2;
+
+      // Left eye coordinates
+      eyeLx = (eyeLx + eyeLxNext) / 2;
+      eyeLy = (eyeLy + eyeLyNext) / 2;
+      // Right eye coordinates
+      eyeRxNext = eyeLxNext + eyeLwidthCurrent + spaceBetweenCurrent; // right eye's x position depends on left eyes position + the space between
+      eyeRyNext = eyeLyNext;                                          // right eye's y position should be the same as for the left eye
+      eyeRx = (eyeRx + eyeRxNext) / 2;
+      eyeRy = (eyeRy + eyeRyNext) / 2;
+
+      // Left eye border radius
+      eyeLborderRadiusCurrent = (eyeLborderRadiusCurrent + eyeLborderRadiusNext) / 2;
+      // Right eye border radius
+      eyeRborderRadiusCurrent = (eyeRborderRadiusCurrent + eyeRborderRadiusNext) / 2;
+    }
 
     //// APPLYING MACRO ANIMATIONS ////
 
@@ -681,21 +849,21 @@ public:
       hFlickerAlternate = !hFlickerAlternate;
     }
 
-    // Adding offsets for horizontal flickering/shivering
+    // Adding offsets for vertical flickering/shivering
     if (vFlicker)
     {
-      if (vFlickerAlternate)
-      {
-        eyeLy += vFlickerAmplitude;
-        eyeRy += vFlickerAmplitude;
-      }
-      else
+      int vShift = vFlickerAlternate ? vFlickerAmplitude : -vFlickerAmplitude;
+      if (!shiftVertically(vShift))
       {
-        eyeLy -= vFlickerAmplitude;
-        eyeRy -= vFlickerAmplitude;
+        eyeLy += vShift;
+        eyeRy += vShift;
       }
       vFlickerAlternate = !vFlickerAlternate;
     }
+    else
+    {
+      shiftVertically(0);
+    }
 
     // Cyclops mode, set second eye's size and space between to 0
     if (cyclops)
@@ -705,17 +873,6 @@ public:
       spaceBetweenCurrent = 0;
     }
 
-    //// ACTUAL DRAWINGS ////
-
-    display->clearDisplay(); // start with a blank screen
-
-    // Draw basic eye rectangles
-    display->fillRoundRect(eyeLx, eyeLy, eyeLwidthCurrent, eyeLheightCurrent, eyeLborderRadiusCurrent, MAINCOLOR); // left eye
-    if (!cyclops)
-    {
-      display->fillRoundRect(eyeRx, eyeRy, eyeRwidthCurrent, eyeRheightCurrent, eyeRborderRadiusCurrent, MAINCOLOR); // right eye
-    }
-
     // Prepare mood type transitions
     if (tired)
     {
@@ -744,40 +901,59 @@ public:
       eyelidsHappyBottomOffsetNext = 0;
     }
 
-    // Draw tired top eyelids
-    eyelidsTiredHeight = (eyelidsTiredHeight + eyelidsTiredHeightNext) / 2;
-    if (!cyclops)
+    // Eyelid tweenings
+    if (tweenMode == TWEEN_TIMED)
     {
-      display->fillTriangle(eyeLx, eyeLy - 1, eyeLx + eyeLwidthCurrent, eyeLy - 1, eyeLx, eyeLy + eyelidsTiredHeight - 1, BGCOLOR);                    // left eye
-      display->fillTriangle(eyeRx, eyeRy - 1, eyeRx + eyeRwidthCurrent, eyeRy - 1, eyeRx + eyeRwidthCurrent, eyeRy + eyelidsTiredHeight - 1, BGCOLOR); // right eye
+      unsigned long now = millis();
+      eyelidsTiredHeight = stepTween(tweenTired, eyelidsTiredHeightNext, TWEEN_LIDS, now);
+      eyelidsAngryHeight = stepTween(tweenAngry, eyelidsAngryHeightNext, TWEEN_LIDS, now);
+      eyelidsHappyBottomOffset = stepTween(tweenHappy, eyelidsHappyBottomOffsetNext, TWEEN_LIDS, now);
     }
     else
     {
-      // Cyclops tired eyelids
-      display->fillTriangle(eyeLx, eyeLy - 1, eyeLx + (eyeLwidthCurrent / 2), eyeLy - 1, eyeLx, eyeLy + eyelidsTiredHeight - 1, BGCOLOR);                                       // left eyelid half
-      display->fillTriangle(eyeLx + (eyeLwidthCurrent / 2), eyeLy - 1, eyeLx + eyeLwidthCurrent, eyeLy - 1, eyeLx + eyeLwidthCurrent, eyeLy + eyelidsTiredHeight - 1, BGCOLOR); // right eyelid half
+      eyelidsTiredHeight = (eyelidsTiredHeight + eyelidsTiredHeightNext) / 2;
+      eyelidsAngryHeight = (eyelidsAngryHeight + eyelidsAngryHeightNext) / 2;
+      eyelidsHappyBottomOffset = (eyelidsHappyBottomOffset + eyelidsHappyBottomOffsetNext) / 2;
     }
 
-    // Draw angry top eyelids
-    eyelidsAngryHeight = (eyelidsAngryHeight + eyelidsAngryHeightNext) / 2;
-    if (!cyclops)
+    //// ACTUAL DRAWINGS ////
+
+    EyeFrame frame = getCurrentFrame();
+
+    // With a hardware shift, vertical flicker does not change the picture in the buffer, only
+    // the start line. While the eyes keep their geometry the buffer is pushed as it is, so the
+    // panel only receives the start line command.
+    if (lastFrameValid && !sweat && hardwareVShift != lastFrameVShift && sameEyeFrame(frame, lastFrame))
     {
-      display->fillTriangle(eyeLx, eyeLy - 1, eyeLx + eyeLwidthCurrent, eyeLy - 1, eyeLx + eyeLwidthCurrent, eyeLy + eyelidsAngryHeight - 1, BGCOLOR); // left eye
-      display->fillTriangle(eyeRx, eyeRy - 1, eyeRx + eyeRwidthCurrent, eyeRy - 1, eyeRx, eyeRy + eyelidsAngryHeight - 1, BGCOLOR);                    // right eye
+      lastFrameVShift = hardwareVShift;
+      framesSkipped++;
+      display->display();
+      return;
     }
-    else
+
+    // Skip render and flush while the eyes would look exactly like the last drawn frame.
+    // Sweat drops and software vertical flicker change the picture without changing the eye
+    // geometry. A hardware shift does not, its start line was already pushed above.
+    bool softwareVShift = vFlicker && hardwareVShift == 0;
+    if (frameSkipping && lastFrameValid && !sweat && !softwareVShift && sameEyeFrame(frame, lastFrame))
     {
-      // Cyclops angry eyelids
-      display->fillTriangle(eyeLx, eyeLy - 1, eyeLx + (eyeLwidthCurrent / 2), eyeLy - 1, eyeLx + (eyeLwidthCurrent / 2), eyeLy + eyelidsAngryHeight - 1, BGCOLOR);                    // left eyelid half
-      display->fillTriangle(eyeLx + (eyeLwidthCurrent / 2), eyeLy - 1, eyeLx + eyeLwidthCurrent, eyeLy - 1, eyeLx + (eyeLwidthCurrent / 2), eyeLy + eyelidsAngryHeight - 1, BGCOLOR); // right eyelid half
+      framesSkipped++;
+      return;
     }
+    lastFrame = frame;
+    lastFrameVShift = hardwareVShift;
+    lastFrameValid = true;
+    framesDrawn++;
 
-    // Draw happy bottom eyelids
-    eyelidsHappyBottomOffset = (eyelidsHappyBottomOffset + eyelidsHappyBottomOffsetNext) / 2;
-    display->fillRoundRect(eyeLx - 1, (eyeLy + eyeLheightCurrent) - eyelidsHappyBottomOffset + 1, eyeLwidthCurrent + 2, eyeLheightDefault, eyeLborderRadiusCurrent, BGCOLOR); // left eye
-    if (!cyclops)
+    display->clearDisplay(); // start with a blank screen
+
+    if (analyticRenderer && canRenderAnalytic(frame))
+    {
+      renderEyesAnalytic(frame, true); // eyes and eyelids in one pass, each column written once
+    }
+    else
     {
-      display->fillRoundRect(eyeRx - 1, (eyeRy + eyeRheightCurrent) - eyelidsHappyBottomOffset + 1, eyeRwidthCurrent + 2, eyeRheightDefault, eyeRborderRadiusCurrent, BGCOLOR); // right eye
+      renderEyesPrimitives(frame); // eyes first, eyelids drawn over them in background color
     }
 
     // Add sweat drops
@@ -816,7 +992,7 @@ public:
       } // vertical movement from initial to max
       else
       {
-        sweat2XPosInitial = random((screenWidth - 60)) + 30;
+        sweat2XPosInitial = random((getScreenWidth() - 60)) + 30;
         sweat2YPos = 2;
         sweat2YPosMax = (random(10) + 10);
         sweat2Width = 1;
@@ -842,7 +1018,7 @@ public:
       } // vertical movement from initial to max
       else
       {
-        sweat3XPosInitial = (screenWidth - 30) + (random(30));
+        sweat3XPosInitial = (getScreenWidth() - 30) + (random(30));
         sweat3YPos = 2;
         sweat3YPosMax = (random(10) + 10);
         sweat3Width = 1;
@@ -866,6 +1042,790 @@ public:
 
   } // end of drawEyes method
 
+  //*********************************************************************************************
+  //  TWEEN ENGINE
+  //*********************************************************************************************
+
+  static void resetTween(Tween &tween, int value)
+  {
+    tween.from = (int32_t)value << 8;
+    tween.value = tween.from;
+    tween.target = value;
+    tween.start = 0;
+    tween.active = false;
+  }
+
+  // Easing curve value for progress t, both in 0..65536 (16.16 fixed point)
+  static int32_t ease(int32_t t, byte easing)
+  {
+    int32_t u = 65536 - t;
+    switch (easing)
+    {
+    case EASE_IN:
+      return (int32_t)(((int64_t)t * t) >> 16);
+    case EASE_OUT:
+      return 65536 - (int32_t)(((int64_t)u * u) >> 16);
+    case EASE_IN_OUT:
+      if (t < 32768)
+        return (int32_t)(((int64_t)t * t) >> 15);
+      return 65536 - (int32_t)(((int64_t)u * u) >> 15);
+    case EASE_OUT_CUBIC:
+      return 65536 - (int32_t)(((((int64_t)u * u) >> 16) * u) >> 16);
+    default:
+      return t;
+    }
+  }
+
+  // Advance a tween to the given time and return its value in whole pixels. A new target
+  // restarts the tween from the current value, so retargeting mid-animation stays smooth.
+  int stepTween(Tween &tween, int target, byte group, unsigned long now)
+  {
+    if (target != tween.target)
+    {
+      tween.from = tween.value;
+      tween.target = target;
+      tween.start = now;
+      tween.active = true;
+    }
+
+    if (tween.active)
+    {
+      const TweenCurve &curve = tweenCurves[group];
+      unsigned long elapsed = now - tween.start;
+      int32_t to = (int32_t)target << 8;
+      if (elapsed >= curve.duration)
+      {
+        tween.value = to;
+        tween.active = false;
+      }
+      else
+      {
+        int32_t t = (int32_t)((elapsed << 16) / curve.duration);
+        tween.value = tween.from + (int32_t)(((int64_t)(to - tween.from) * ease(t, curve.easing)) >> 16);
+      }
+    }
+
+    return (tween.value + 128) >> 8; // round to nearest pixel
+  }
+
+  // Time based replacement for the halving tweens: the eye position is tweened as the top of an
+  // eye at default height, the drawn position is derived from it every frame
+  void updateTimedTweens()
+  {
+    unsigned long now = millis();
+
+    eyeLheightCurrent = stepTween(tweenLheight, eyeLheightNext + eyeLheightOffset, TWEEN_SIZE, now);
+    eyeRheightCurrent = stepTween(tweenRheight, eyeRheightNext + eyeRheightOffset, TWEEN_SIZE, now);
+    eyeLwidthCurrent = stepTween(tweenLwidth, eyeLwidthNext, TWEEN_SIZE, now);
+    eyeRwidthCurrent = stepTween(tweenRwidth, eyeRwidthNext, TWEEN_SIZE, now);
+    spaceBetweenCurrent = stepTween(tweenSpace, spaceBetweenNext, TWEEN_POSITION, now);
+
+    int baseX = stepTween(tweenX, eyeLxNext, TWEEN_POSITION, now);
+    int baseY = stepTween(tweenY, eyeLyNext, TWEEN_POSITION, now);
+
+    // Left eye, centered vertically while blinking or enlarged by curiosity
+    eyeLx = baseX;
+    eyeLy = baseY + (eyeLheightDefault - eyeLheightCurrent) / 2 - eyeLheightOffset / 2;
+    // Right eye follows the left eye's position and the space between
+    eyeRxNext = eyeLxNext + eyeLwidthCurrent + spaceBetweenCurrent;
+    eyeRyNext = eyeLyNext;
+    eyeRx = baseX + eyeLwidthCurrent + spaceBetweenCurrent;
+    eyeRy = baseY + (eyeRheightDefault - eyeRheightCurrent) / 2 - eyeRheightOffset / 2;
+
+    eyeLborderRadiusCurrent = stepTween(tweenLradius, eyeLborderRadiusNext, TWEEN_RADIUS, now);
+    eyeRborderRadiusCurrent = stepTween(tweenRradius, eyeRborderRadiusNext, TWEEN_RADIUS, now);
+  }
+
+  // Hand a vertical flicker offset to the hardware shift handler. Rows wrapping around the
+  // screen edge must be empty, so this only works while the eyes keep clear of that edge
+  // and no sweat drops are drawn at the top.
+  bool shiftVertically(int rows)
+  {
+    if (!verticalShiftHandler)
+      return false;
+
+    if (rows != 0)
+    {
+      int top = eyeLy;
+      int bottom = eyeLy + eyeLheightCurrent;
+      if (!cyclops)
+      {
+        top = min(top, eyeRy);
+        bottom = max(bottom, eyeRy + eyeRheightCurrent);
+      }
+      bool wrapsBlank = rows > 0 ? (bottom <= getScreenHeight() - rows) : (top >= -rows);
+      if (sweat || !wrapsBlank)
+      {
+        verticalShiftHandler(0);
+        hardwareVShift = 0;
+        return false;
+      }
+    }
+
+    bool shifted = verticalShiftHandler(rows);
+    hardwareVShift = shifted ? rows : 0;
+    return shifted;
+  }
+
+  //*********************************************************************************************
+  //  EYE RENDERERS
+  //*********************************************************************************************
+
+  // Final geometry of one frame, as consumed by both eye renderers
+  struct EyeFrame
+  {
+    int lx, ly, lw, lh, lhDefault;
+    int rx, ry, rw, rh, rhDefault;
+    byte lr, rr;
+    byte tiredHeight;
+    byte angryHeight;
+    byte happyOffset;
+    bool cyclops;
+  };
+
+  // The analytic renderer keeps one 64 bit row mask per eye column, so it handles eyes up to
+  // 64 pixels high. Both eyes (including the eyelid cutouts reaching one column beyond each
+  // eye) must not share a column, otherwise the reference renderer's overdraw order matters.
+  static const int ANALYTIC_MAX_EYE_WIDTH = 64;
+  static const int ANALYTIC_MAX_EYE_HEIGHT = 64;
+
+  // Pre-rasterized eye shapes, keyed by everything that affects the shape but not its position.
+  // Each slot holds the row masks of up to 64 columns (512 bytes) plus its key and LRU state,
+  // sizeof(EyeSprite) = 544 bytes on the ESP32-C3.
+  struct EyeSpriteKey
+  {
+    int width;
+    int height;
+    byte radius;
+    int heightDefault;
+    byte tiredHeight;
+    byte angryHeight;
+    byte happyOffset;
+    bool leftEye;
+  };
+
+  struct EyeSprite
+  {
+    EyeSpriteKey key;
+    bool used;
+    unsigned long lastUse;
+    uint64_t columns[ANALYTIC_MAX_EYE_WIDTH];
+  };
+
+  EyeFrame getCurrentFrame()
+  {
+    EyeFrame frame;
+    frame.lx = eyeLx;
+    frame.ly = eyeLy;
+    frame.lw = eyeLwidthCurrent;
+    frame.lh = eyeLheightCurrent;
+    frame.lhDefault = eyeLheightDefault;
+    frame.lr = eyeLborderRadiusCurrent;
+    frame.rx = eyeRx;
+    frame.ry = eyeRy;
+    frame.rw = eyeRwidthCurrent;
+    frame.rh = eyeRheightCurrent;
+    frame.rhDefault = eyeRheightDefault;
+    frame.rr = eyeRborderRadiusCurrent;
+    frame.tiredHeight = eyelidsTiredHeight;
+    frame.angryHeight = eyelidsAngryHeight;
+    frame.happyOffset = eyelidsHappyBottomOffset;
+    frame.cyclops = cyclops;
+    return frame;
+  }
+
+  // Reference renderer: rounded rectangles with eyelids overdrawn in background color
+  void renderEyesPrimitives(const EyeFrame &f)
+  {
+    // Draw basic eye rectangles
+    display->fillRoundRect(f.lx, f.ly, f.lw, f.lh, f.lr, MAINCOLOR); // left eye
+    if (!f.cyclops)
+    {
+      display->fillRoundRect(f.rx, f.ry, f.rw, f.rh, f.rr, MAINCOLOR); // right eye
+    }
+
+    // Draw tired top eyelids
+    if (!f.cyclops)
+    {
+      display->fillTriangle(f.lx, f.ly - 1, f.lx + f.lw, f.ly - 1, f.lx, f.ly + f.tiredHeight - 1, BGCOLOR);               // left eye
+      display->fillTriangle(f.rx, f.ry - 1, f.rx + f.rw, f.ry - 1, f.rx + f.rw, f.ry + f.tiredHeight - 1, BGCOLOR);        // right eye
+    }
+    else
+    {
+      // Cyclops tired eyelids
+      display->fillTriangle(f.lx, f.ly - 1, f.lx + (f.lw / 2), f.ly - 1, f.lx, f.ly + f.tiredHeight - 1, BGCOLOR);                          // left eyelid half
+      display->fillTriangle(f.lx + (f.lw / 2), f.ly - 1, f.lx + f.lw, f.ly - 1, f.lx + f.lw, f.ly + f.tiredHeight - 1, BGCOLOR);             // right eyelid half
+    }
+
+    // Draw angry top eyelids
+    if (!f.cyclops)
+    {
+      display->fillTriangle(f.lx, f.ly - 1, f.lx + f.lw, f.ly - 1, f.lx + f.lw, f.ly + f.angryHeight - 1, BGCOLOR); // left eye
+      display->fillTriangle(f.rx, f.ry - 1, f.rx + f.rw, f.ry - 1, f.rx, f.ry + f.angryHeight - 1, BGCOLOR);        // right eye
+    }
+    else
+    {
+      // Cyclops angry eyelids
+      display->fillTriangle(f.lx, f.ly - 1, f.lx + (f.lw / 2), f.ly - 1, f.lx + (f.lw / 2), f.ly + f.angryHeight - 1, BGCOLOR);              // left eyelid half
+      display->fillTriangle(f.lx + (f.lw / 2), f.ly - 1, f.lx + f.lw, f.ly - 1, f.lx + (f.lw / 2), f.ly + f.angryHeight - 1, BGCOLOR);       // right eyelid half
+    }
+
+    // Draw happy bottom eyelids
+    display->fillRoundRect(f.lx - 1, (f.ly + f.lh) - f.happyOffset + 1, f.lw + 2, f.lhDefault, f.lr, BGCOLOR); // left eye
+    if (!f.cyclops)
+    {
+      display->fillRoundRect(f.rx - 1, (f.ry + f.rh) - f.happyOffset + 1, f.rw + 2, f.rhDefault, f.rr, BGCOLOR); // right eye
+    }
+  }
+
+  bool canRenderAnalytic(const EyeFrame &f)
+  {
+    if (f.cyclops)
+      return false;
+    if (f.lw <= 0 || f.rw <= 0 || f.lh <= 0 || f.rh <= 0)
+      return false;
+    if (f.lw > ANALYTIC_MAX_EYE_WIDTH || f.rw > ANALYTIC_MAX_EYE_WIDTH)
+      return false;
+    if (f.lh > ANALYTIC_MAX_EYE_HEIGHT || f.rh > ANALYTIC_MAX_EYE_HEIGHT)
+      return false;
+    return (f.lx + f.lw) < (f.rx - 1); // left eye's cutouts end before the right eye's start
+  }
+
+  // Single pass renderer: computes the lit rows of every eye column after applying the tired,
+  // angry and happy eyelids, then writes each column with a single vertical line per lit run.
+  // Pixel-identical to renderEyesPrimitives() for every frame accepted by canRenderAnalytic().
+  // With useCache, eye shapes that did not change since the previous frame come from the sprite cache.
+  void renderEyesAnalytic(const EyeFrame &f, bool useCache)
+  {
+    // Left eye: tired lid slopes down to the left, angry lid slopes down to the right
+    EyeSpriteKey leftKey = {f.lw, f.lh, f.lr, f.lhDefault, f.tiredHeight, f.angryHeight, f.happyOffset, true};
+    renderEyeAnalytic(f.lx, f.ly, leftKey, useCache, lastLeftEyeKey);
+
+    // Right eye: mirrored eyelid slopes
+    EyeSpriteKey rightKey = {f.rw, f.rh, f.rr, f.rhDefault, f.tiredHeight, f.angryHeight, f.happyOffset, false};
+    renderEyeAnalytic(f.rx, f.ry, rightKey, useCache, lastRightEyeKey);
+  }
+
+  void renderEyeAnalytic(int x, int y, const EyeSpriteKey &key, bool useCache, EyeSpriteKey &lastKey)
+  {
+    // Only shapes that stayed the same for two frames are cached, so tweening frames are
+    // rasterized directly and do not evict the resting shapes
+    bool settled = useCache && spriteCache && sameEyeSpriteKey(key, lastKey);
+    lastKey = key;
+
+    if (settled)
+    {
+      EyeSprite *sprite = findEyeSprite(key);
+      if (sprite)
+      {
+        spriteCacheHits++;
+      }
+      else
+      {
+        spriteCacheMisses++;
+        sprite = evictEyeSprite();
+        sprite->key = key;
+        sprite->used = true;
+        rasterizeEye(x, y, key.width, key.height, key.radius, key.heightDefault, key.tiredHeight, key.angryHeight, key.happyOffset, key.leftEye, sprite->columns);
+      }
+      sprite->lastUse = ++spriteCacheClock;
+      writeEyeColumns(x, y, key.width, sprite->columns);
+      writeEyeEdges(x, y, key.width, sprite->columns);
+      return;
+    }
+
+    uint64_t columns[ANALYTIC_MAX_EYE_WIDTH];
+    rasterizeEye(x, y, key.width, key.height, key.radius, key.heightDefault, key.tiredHeight, key.angryHeight, key.happyOffset, key.leftEye, columns);
+    writeEyeColumns(x, y, key.width, columns);
+    writeEyeEdges(x, y, key.width, columns);
+  }
+
+  //*********************************************************************************************
+  //  EYE SPRITE CACHE
+  //*********************************************************************************************
+
+  // For skipping frames that would not change the picture
+  bool frameSkipping = 0;
+  bool lastFrameValid = 0;
+  EyeFrame lastFrame;
+  int lastFrameVShift = 0;
+  unsigned long framesDrawn = 0;
+  unsigned long framesSkipped = 0;
+
+  static bool sameEyeFrame(const EyeFrame &a, const EyeFrame &b)
+  {
+    return a.lx == b.lx && a.ly == b.ly && a.lw == b.lw && a.lh == b.lh && a.lhDefault == b.lhDefault &&
+           a.rx == b.rx && a.ry == b.ry && a.rw == b.rw && a.rh == b.rh && a.rhDefault == b.rhDefault &&
+           a.lr == b.lr && a.rr == b.rr && a.tiredHeight == b.tiredHeight && a.angryHeight == b.angryHeight &&
+           a.happyOffset == b.happyOffset && a.cyclops == b.cyclops;
+  }
+
+  EyeSprite *spriteCache = nullptr;
+  byte spriteCacheSlots = 0;
+  unsigned long spriteCacheClock = 0;
+  unsigned long spriteCacheHits = 0;
+  unsigned long spriteCacheMisses = 0;
+  EyeSpriteKey lastLeftEyeKey = {};
+  EyeSpriteKey lastRightEyeKey = {};
+
+  // Set sprite cache size in slots (0 = disabled), only used together with the analytic renderer
+  bool setSpriteCache(byte slots)
+  {
+    free(spriteCache);
+    spriteCache = nullptr;
+    spriteCacheSlots = 0;
+    if (slots == 0)
+      return true;
+
+    spriteCache = (EyeSprite *)malloc(sizeof(EyeSprite) * slots);
+    if (!spriteCache)
+      return false;
+    spriteCacheSlots = slots;
+    clearSpriteCache();
+    return true;
+  }
+
+  void clearSpriteCache()
+  {
+    for (byte i = 0; i < spriteCacheSlots; i++)
+    {
+      spriteCache[i].used = false;
+      spriteCache[i].lastUse = 0;
+    }
+  }
+
+  unsigned long getSpriteCacheHits()
+  {
+    return spriteCacheHits;
+  }
+
+  unsigned long getSpriteCacheMisses()
+  {
+    return spriteCacheMisses;
+  }
+
+  void resetSpriteCacheStats()
+  {
+    spriteCacheHits = 0;
+    spriteCacheMisses = 0;
+  }
+
+  static bool sameEyeSpriteKey(const EyeSpriteKey &a, const EyeSpriteKey &b)
+  {
+    return a.width == b.width && a.height == b.height && a.radius == b.radius && a.heightDefault == b.heightDefault &&
+           a.tiredHeight == b.tiredHeight && a.angryHeight == b.angryHeight && a.happyOffset == b.happyOffset &&
+           a.leftEye == b.leftEye;
+  }
+
+  EyeSprite *findEyeSprite(const EyeSpriteKey &key)
+  {
+    for (byte i = 0; i < spriteCacheSlots; i++)
+    {
+      if (spriteCache[i].used && sameEyeSpriteKey(spriteCache[i].key, key))
+        return &spriteCache[i];
+    }
+    return nullptr;
+  }
+
+  // Returns a free slot, or the least recently used one
+  EyeSprite *evictEyeSprite()
+  {
+    EyeSprite *oldest = &spriteCache[0];
+    for (byte i = 0; i < spriteCacheSlots; i++)
+    {
+      if (!spriteCache[i].used)
+        return &spriteCache[i];
+      if (spriteCache[i].lastUse < oldest->lastUse)
+        oldest = &spriteCache[i];
+    }
+    return oldest;
+  }
+
+  // Row mask (bit 0 = eye top row) of rows top..bottom, clipped to the 64 rows of an eye column
+  static uint64_t rowSpanMask(int top, int bottom)
+  {
+    if (top < 0)
+      top = 0;
+    if (bottom > 63)
+      bottom = 63;
+    if (top > bottom)
+      return 0;
+    uint64_t upToBottom = (bottom == 63) ? ~0ULL : ((1ULL << (bottom + 1)) - 1);
+    return upToBottom & ~((1ULL << top) - 1);
+  }
+
+  // Same column coverage as Adafruit_GFX::fillRoundRect(), as row masks relative to rowOrigin.
+  // Columns are relative to the eye, only columns 0..eyeWidth-1 are kept.
+  static void roundRectColumns(int x, int y, int w, int h, int r, int rowOrigin, int eyeWidth, uint64_t *columns, bool clear)
+  {
+    int maxRadius = ((w < h) ? w : h) / 2;
+    if (r > maxRadius)
+      r = maxRadius;
+
+    // Straight middle part
+    for (int c = x + r; c < x + w - r; c++)
+    {
+      if (c >= 0 && c < eyeWidth)
+        applyColumnSpan(columns[c], y, y + h - 1, rowOrigin, clear);
+    }
+
+    // Rounded corners, same midpoint circle walk as Adafruit_GFX::fillCircleHelper()
+    int rightCenter = x + w - r - 1;
+    int leftCenter = x + r;
+    int centerY = y + r;
+    int delta = h - 2 * r; // already incremented, as in fillCircleHelper()
+    int f = 1 - r;
+    int ddFx = 1;
+    int ddFy = -2 * r;
+    int cx = 0;
+    int cy = r;
+    int px = cx;
+    int py = cy;
+
+    while (cx < cy)
+    {
+      if (f >= 0)
+      {
+        cy--;
+        ddFy += 2;
+        f += ddFy;
+      }
+      cx++;
+      ddFx += 2;
+      f += ddFx;
+      if (cx < (cy + 1))
+      {
+        cornerColumns(rightCenter + cx, leftCenter - cx, centerY - cy, 2 * cy + delta, rowOrigin, eyeWidth, columns, clear);
+      }
+      if (cy != py)
+      {
+        cornerColumns(rightCenter + py, leftCenter - py, centerY - px, 2 * px + delta, rowOrigin, eyeWidth, columns, clear);
+        py = cy;
+      }
+      px = cx;
+    }
+  }
+
+  static void cornerColumns(int rightCol, int leftCol, int top, int length, int rowOrigin, int eyeWidth, uint64_t *columns, bool clear)
+  {
+    if (length <= 0)
+      return;
+    if (rightCol >= 0 && rightCol < eyeWidth)
+      applyColumnSpan(columns[rightCol], top, top + length - 1, rowOrigin, clear);
+    if (leftCol >= 0 && leftCol < eyeWidth)
+      applyColumnSpan(columns[leftCol], top, top + length - 1, rowOrigin, clear);
+  }
+
+  static void applyColumnSpan(uint64_t &column, int top, int bottom, int rowOrigin, bool clear)
+  {
+    uint64_t mask = rowSpanMask(top - rowOrigin, bottom - rowOrigin);
+    if (clear)
+      column &= ~mask;
+    else
+      column |= mask;
+  }
+
+  // Same scanline coverage as Adafruit_GFX::fillTriangle(), cleared from the row masks
+  static void clearTriangleColumns(int x0, int y0, int x1, int y1, int x2, int y2, int eyeX, int eyeY, int eyeWidth, uint64_t *columns)
+  {
+    int a, b, y, last;
+
+    // Sort coordinates by Y order (y2 >= y1 >= y0)
+    if (y0 > y1)
+    {
+      swapInt(y0, y1);
+      swapInt(x0, x1);
+    }
+    if (y1 > y2)
+    {
+      swapInt(y2, y1);
+      swapInt(x2, x1);
+    }
+    if (y0 > y1)
+    {
+      swapInt(y0, y1);
+      swapInt(x0, x1);
+    }
+
+    if (y0 == y2)
+    {
+      // All points on the same scanline
+      a = b = x0;
+      if (x1 < a)
+        a = x1;
+      else if (x1 > b)
+        b = x1;
+      if (x2 < a)
+        a = x2;
+      else if (x2 > b)
+        b = x2;
+      clearScanline(a, b, y0, eyeX, eyeY, eyeWidth, columns);
+      return;
+    }
+
+    int dx01 = x1 - x0, dy01 = y1 - y0, dx02 = x2 - x0, dy02 = y2 - y0, dx12 = x2 - x1, dy12 = y2 - y1;
+    int32_t sa = 0, sb = 0;
+
+    if (y1 == y2)
+      last = y1; // include y1 scanline
+    else
+      last = y1 - 1; // skip it
+
+    for (y = y0; y <= last; y++)
+    {
+      a = x0 + sa / dy01;
+      b = x0 + sb / dy02;
+      sa += dx01;
+      sb += dx02;
+      if (a > b)
+        swapInt(a, b);
+      clearScanline(a, b, y, eyeX, eyeY, eyeWidth, columns);
+    }
+
+    sa = (int32_t)dx12 * (y - y1);
+    sb = (int32_t)dx02 * (y - y0);
+    for (; y <= y2; y++)
+    {
+      a = x1 + sa / dy12;
+      b = x0 + sb / dy02;
+      sa += dx12;
+      sb += dx02;
+      if (a > b)
+        swapInt(a, b);
+      clearScanline(a, b, y, eyeX, eyeY, eyeWidth, columns);
+    }
+  }
+
+  static void clearScanline(int a, int b, int y, int eyeX, int eyeY, int eyeWidth, uint64_t *columns)
+  {
+    int row = y - eyeY;
+    if (row < 0 || row > 63)
+      return;
+    uint64_t keep = ~(1ULL << row);
+    int first = max(a - eyeX, 0);
+    int lastCol = min(b - eyeX, eyeWidth - 1);
+    for (int c = first; c <= lastCol; c++)
+    {
+      columns[c] &= keep;
+    }
+  }
+
+  static void swapInt(int &a, int &b)
+  {
+    int t = a;
+    a = b;
+    b = t;
+  }
+
+  // Row masks of one eye after applying all eyelids, bit 0 = row y
+  static void rasterizeEye(int x, int y, int w, int h, byte r, int hDefault, byte tiredHeight, byte angryHeight, byte happyOffset, bool leftEye, uint64_t *columns)
+  {
+    for (int c = 0; c < w; c++)
+    {
+      columns[c] = 0;
+    }
+
+    // Eye body
+    roundRectColumns(0, y, w, h, r, y, w, columns, false);
+
+    // Tired top eyelid
+    if (leftEye)
+      clearTriangleColumns(x, y - 1, x + w, y - 1, x, y + tiredHeight - 1, x, y, w, columns);
+    else
+      clearTriangleColumns(x, y - 1, x + w, y - 1, x + w, y + tiredHeight - 1, x, y, w, columns);
+
+    // Angry top eyelid
+    if (leftEye)
+      clearTriangleColumns(x, y - 1, x + w, y - 1, x + w, y + angryHeight - 1, x, y, w, columns);
+    else
+      clearTriangleColumns(x, y - 1, x + w, y - 1, x, y + angryHeight - 1, x, y, w, columns);
+
+    // Happy bottom eyelid, one column wider than the eye on each side
+    roundRectColumns(-1, (y + h) - happyOffset + 1, w + 2, hDefault, r, y, w, columns, true);
+  }
+
+  // Write the lit runs of each eye column, usually a single run per column
+  void writeEyeColumns(int x, int y, int w, const uint64_t *columns)
+  {
+    // Only columns on the panel, constant bounds for fixed geometry instantiations
+    int first = x < 0 ? -x : 0;
+    int last = x + w > getScreenWidth() ? getScreenWidth() - x : w;
+    for (int c = first; c < last; c++)
+    {
+      uint64_t bits = columns[c];
+      int row = 0;
+      while (bits)
+      {
+        while (!(bits & 1))
+        {
+          bits >>= 1;
+          row++;
+        }
+        int start = row;
+        while (bits & 1)
+        {
+          bits >>= 1;
+          row++;
+        }
+        display->drawFastVLine(x + c, y + start, row - start, MAINCOLOR);
+      }
+    }
+  }
+
+  // Outline of the lit eye pixels (4-neighbourhood), from one column left of the eye to one
+  // column right of it. The row above the eye is handled separately, as it has no mask bit.
+  void writeEyeEdges(int x, int y, int w, const uint64_t *columns)
+  {
+    if (!softEdgeHandler)
+      return;
+
+    for (int c = -1; c <= w; c++)
+    {
+      uint64_t self = (c >= 0 && c < w) ? columns[c] : 0;
+      uint64_t left = (c > 0) ? columns[c - 1] : 0;
+      uint64_t right = (c + 1 < w) ? columns[c + 1] : 0;
+      uint64_t edge = (left | right | (self << 1) | (self >> 1)) & ~self;
+
+      if (self & 1)
+      {
+        softEdgeHandler(x + c, y - 1, 1);
+      }
+
+      int row = 0;
+      while (edge)
+      {
+        while (!(edge & 1))
+        {
+          edge >>= 1;
+          row++;
+        }
+        int start = row;
+        while (edge & 1)
+        {
+          edge >>= 1;
+          row++;
+        }
+        softEdgeHandler(x + c, y + start, row - start);
+      }
+    }
+  }
+
+  // Renders random eye frames with both renderers and compares the framebuffers.
+  // Returns the number of mismatching frames; needs a display with getBuffer(), e.g. Adafruit_SSD1306.
+  int verifyAnalyticRenderer(int samples)
+  {
+    int bufferSize = display->width() * ((display->height() + 7) / 8);
+    uint8_t *reference = (uint8_t *)malloc(bufferSize);
+    if (!reference)
+      return -1;
+
+    // Test shapes go to a scratch cache, so the live sprites, their stats
+    // and the last eye keys are left as they were
+    EyeSprite *liveCache = spriteCache;
+    byte liveSlots = spriteCacheSlots;
+    unsigned long liveClock = spriteCacheClock;
+    unsigned long liveHits = spriteCacheHits;
+    unsigned long liveMisses = spriteCacheMisses;
+    EyeSpriteKey liveLeftKey = lastLeftEyeKey;
+    EyeSpriteKey liveRightKey = lastRightEyeKey;
+    spriteCache = liveCache ? (EyeSprite *)malloc(sizeof(EyeSprite) * liveSlots) : nullptr;
+    spriteCacheSlots = spriteCache ? liveSlots : 0;
+    clearSpriteCache();
+
+    int compared = 0;
+    int mismatches = 0;
+
+    for (int i = 0; i < samples; i++)
+    {
+      EyeFrame f;
+      f.cyclops = false;
+      f.lw = random(8, 49);
+      f.rw = random(8, 49);
+      f.lh = random(1, 49);
+      f.rh = f.lh;
+      f.lhDefault = random(1, 49);
+      f.rhDefault = f.lhDefault;
+      f.lr = random(0, 13);
+      f.rr = f.lr;
+      f.lx = random(-10, 60);
+      f.rx = f.lx + f.lw + random(-4, 20);
+      f.ly = random(-10, 40);
+      f.ry = f.ly + random(-2, 3);
+      f.tiredHeight = random(0, f.lh / 2 + 1);
+      f.angryHeight = random(0, f.lh / 2 + 1);
+      f.happyOffset = random(0, f.lh / 2 + 1);
+
+      if (!canRenderAnalytic(f))
+        continue;
+
+      display->clearDisplay();
+      renderEyesPrimitives(f);
+      memcpy(reference, display->getBuffer(), bufferSize);
+
+      display->clearDisplay();
+      renderEyesAnalytic(f, false);
+
+      compared++;
+      if (memcmp(reference, display->getBuffer(), bufferSize) != 0)
+      {
+        mismatches++;
+        continue;
+      }
+
+      if (spriteCache)
+      {
+        // Same shape twice to get it cached, then served from the cache at a new position
+        renderEyesAnalytic(f, true);
+        renderEyesAnalytic(f, true);
+        int dx = random(-3, 4);
+        int dy = random(-3, 4);
+        f.lx += dx;
+        f.rx += dx;
+        f.ly += dy;
+        f.ry += dy;
+
+        display->clearDisplay();
+        renderEyesPrimitives(f);
+        memcpy(reference, display->getBuffer(), bufferSize);
+
+        display->clearDisplay();
+        renderEyesAnalytic(f, true);
+
+        if (memcmp(reference, display->getBuffer(), bufferSize) != 0)
+        {
+          mismatches++;
+        }
+      }
+    }
+
+    free(reference);
+    free(spriteCache);
+    spriteCache = liveCache;
+    spriteCacheSlots = liveSlots;
+    spriteCacheClock = liveClock;
+    spriteCacheHits = liveHits;
+    spriteCacheMisses = liveMisses;
+    lastLeftEyeKey = liveLeftKey;
+    lastRightEyeKey = liveRightKey;
+
+    // The buffer no longer holds the eyes, the next drawEyes() must render
+    display->clearDisplay();
+    invalidateFrame();
+
+    Log.print("RoboEyes renderer check: ");
+    Log.print(compared);
+    Log.print(" frames compared, ");
+    Log.print(mismatches);
+    Log.println(" mismatches");
+
+    return mismatches;
+  }
+
 }; // end of class roboEyes
 
+template <typename AdafruitDisplay, int FixedWidth, int FixedHeight>
+uint8_t RoboEyes<AdafruitDisplay, FixedWidth, FixedHeight>::BGCOLOR = 0;
+template <typename AdafruitDisplay, int FixedWidth, int FixedHeight>
+uint8_t RoboEyes<AdafruitDisplay, FixedWidth, FixedHeight>::MAINCOLOR = 1;
+
 #endif
\ No newline at end of file
@@ -0,0 +1,145 @@
+#include "FrameGovernor.h"
+#include "SerialLog.h"
+
+FrameGovernor::FrameGovernor(DisplayManager &disp, const char *screenName)
+    : display(disp),
+      name(screenName),
+      baseInterval(33),
+      level(GOVERNOR_FULL),
+      frameStart(0),
+      waitAtStart(0),
+      inFrame(false),
+      renderAverage(0),
+      flushAverage(0),
+      overrunFrames(0),
+      headroomFrames(0),
+      lastLevelChange(0)
+{
+  static const GovernorLevel DEFAULT_STEPS[] = {GOVERNOR_DROP_PEAKS, GOVERNOR_COARSE_MARQUEE,
+                                                GOVERNOR_DROP_SWEAT, GOVERNOR_HALF_RATE};
+  setSteps(DEFAULT_STEPS, GOVERNOR_MAX_LEVEL);
+}
+
+void FrameGovernor::setSteps(const GovernorLevel *order, int count)
+{
+  stepCount = constrain(count, 0, (int)GOVERNOR_MAX_LEVEL);
+  for (int i = 0; i < stepCount; i++)
+  {
+    steps[i] = order[i];
+  }
+  level = min(level, stepCount);
+}
+
+void FrameGovernor::setFrameInterval(unsigned long interval)
+{
+  baseInterval = max(1UL, interval);
+}
+
+bool FrameGovernor::shedAt(int atLevel, GovernorLevel feature)
+{
+  for (int i = 0; i < atLevel && i < stepCount; i++)
+  {
+    if (steps[i] == feature)
+      return true;
+  }
+  return false;
+}
+
+unsigned long FrameGovernor::intervalAt(int atLevel)
+{
+  return shedAt(atLevel, GOVERNOR_HALF_RATE) ? baseInterval * 2 : baseInterval;
+}
+
+unsigned long FrameGovernor::getFrameInterval()
+{
+  return intervalAt(level);
+}
+
+void FrameGovernor::beginFrame()
+{
+  frameStart = micros();
+  waitAtStart = display.getFlushStats().waitTime;
+  inFrame = true;
+}
+
+void FrameGovernor::endFrame(bool drawn)
+{
+  if (!inFrame)
+    return;
+  inFrame = false;
+  if (!drawn)
+    return;
+
+  FlushStats stats = display.getFlushStats();
+  unsigned long render = micros() - frameStart;
+  // Waktu menunggu flush sebelumnya berarti bus lebih lambat dari render
+  unsigned long waited = stats.waitTime - waitAtStart;
+  unsigned long flush = max(stats.lastFlushTime, waited);
+
+  renderAverage = renderAverage == 0 ? render : (renderAverage * 7 + render) / 8;
+  flushAverage = flushAverage == 0 ? flush : (flushAverage * 7 + flush) / 8;
+
+  unsigned long interval = getFrameInterval() * 1000;
+  unsigned long renderBudget = interval * LOAD_PERCENT / 100;
+  bool overrun = renderAverage > renderBudget || flushAverage > interval;
+  // Ruang dihitung terhadap interval level di bawahnya, supaya frame rate
+  // yang dikembalikan tidak langsung overrun lagi
+  unsigned long lowerInterval = intervalAt(level - 1) * 1000;
+  unsigned long headroomLimit = lowerInterval * HEADROOM_PERCENT / 100;
+  bool headroom = renderAverage < headroomLimit && flushAverage < headroomLimit;
+
+  overrunFrames = overrun ? overrunFrames + 1 : 0;
+  headroomFrames = headroom ? headroomFrames + 1 : 0;
+
+  unsigned long now = millis();
+  if (overrunFrames >= OVERRUN_FRAMES && level < stepCount && now - lastLevelChange >= RAISE_HOLD)
+  {
+    setLevel(level + 1);
+  }
+  else if (headroomFrames >= HEADROOM_FRAMES && level > GOVERNOR_FULL && now - lastLevelChange >= LOWER_HOLD)
+  {
+    setLevel(level - 1);
+  }
+}
+
+void FrameGovernor::setLevel(int newLevel)
+{
+  level = newLevel;
+  overrunFrames = 0;
+  headroomFrames = 0;
+  lastLevelChange = millis();
+
+  Log.printf("[Governor] %s level %d (render %lu us, flush %lu us, interval %lu ms)\n",
+                name, level, renderAverage, flushAverage, getFrameInterval());
+}
+
+void FrameGovernor::reset()
+{
+  level = GOVERNOR_FULL;
+  inFrame = false;
+  renderAverage = 0;
+  flushAverage = 0;
+  overrunFrames = 0;
+  headroomFrames = 0;
+  lastLevelChange = millis();
+}
+
+int FrameGovernor::getLevel()
+{
+  return level;
+}
+
+bool FrameGovernor::allows(GovernorLevel feature)
+{
+  return !shedAt(level, feature);
+}
+
+unsigned long FrameGovernor::getRenderTime()
+{
+  return renderAverage;
+}
+
+unsigned long FrameGovernor::getFlushTime()
+{
+  return flushAverage;
+}
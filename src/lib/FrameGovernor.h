@@ -0,0 +1,82 @@
+#ifndef FRAME_GOVERNOR_H
+#define FRAME_GOVERNOR_H
+
+#include <Arduino.h>
+#include "DisplayManager.h"
+
+// Efek opsional yang dilepas berurutan saat frame melewati budget. Tiap
+// layar memberi urutan efek yang berpengaruh baginya lewat setSteps();
+// level N berarti N efek pertama di urutan itu nonaktif. Tanpa setSteps()
+// urutannya mengikuti nilai enum.
+enum GovernorLevel
+{
+  GOVERNOR_FULL,           // semua efek aktif
+  GOVERNOR_DROP_PEAKS,     // tanpa penanda peak visualizer
+  GOVERNOR_COARSE_MARQUEE, // marquee bergeser 2 px per langkah
+  GOVERNOR_DROP_SWEAT,     // tanpa tetes keringat mata
+  GOVERNOR_HALF_RATE,      // interval frame target dua kali lipat
+  GOVERNOR_MAX_LEVEL = GOVERNOR_HALF_RATE
+};
+
+// Mengukur waktu render (termasuk menunggu flush sebelumnya) dan waktu
+// flush tiap frame satu layar, lalu menaikkan level jika frame melewati
+// budget dan menurunkannya lagi setelah ada ruang. Budget render hanya
+// sebagian interval frame agar loop() tetap sempat menangani tombol dan BLE.
+class FrameGovernor
+{
+private:
+  DisplayManager &display;
+  const char *name;
+
+  unsigned long baseInterval; // ms, interval target tanpa degradasi
+  int level;                  // jumlah langkah yang sedang dilepas
+
+  GovernorLevel steps[GOVERNOR_MAX_LEVEL];
+  int stepCount;
+
+  unsigned long frameStart;
+  unsigned long waitAtStart;
+  bool inFrame;
+
+  // Rata-rata bergerak (us), bobot 1/8 untuk frame terbaru
+  unsigned long renderAverage;
+  unsigned long flushAverage;
+  int overrunFrames;
+  int headroomFrames;
+  unsigned long lastLevelChange;
+
+  static const int LOAD_PERCENT = 70;     // bagian interval untuk render
+  static const int HEADROOM_PERCENT = 40; // di bawah ini level diturunkan
+  static const int OVERRUN_FRAMES = 4;
+  static const int HEADROOM_FRAMES = 30;
+  static const unsigned long RAISE_HOLD = 500;
+  static const unsigned long LOWER_HOLD = 2000;
+
+  void setLevel(int newLevel);
+  bool shedAt(int atLevel, GovernorLevel feature);
+  unsigned long intervalAt(int atLevel);
+
+public:
+  FrameGovernor(DisplayManager &disp, const char *screenName);
+
+  // Urutan efek yang dilepas layar ini, efek yang tidak berpengaruh
+  // dilewati agar degradasi tidak menunggu langkah kosong
+  void setSteps(const GovernorLevel *order, int count);
+  void setFrameInterval(unsigned long interval);
+  // Interval setelah degradasi frame rate
+  unsigned long getFrameInterval();
+
+  void beginFrame();
+  // drawn = false jika tidak ada frame yang dirender (mis. frame skipping)
+  void endFrame(bool drawn = true);
+  void reset();
+
+  int getLevel();
+  // false jika efek pada level itu sedang dilepas
+  bool allows(GovernorLevel feature);
+
+  unsigned long getRenderTime();
+  unsigned long getFlushTime();
+};
+
+#endif
@@ -0,0 +1,328 @@
+#include "FrameMirror.h"
+#include "SerialLog.h"
+
+FrameMirror::FrameMirror(DisplayManager &disp, BLEManager &bleManager)
+    : display(disp),
+      ble(bleManager),
+      transport(MIRROR_OFF),
+      width(0),
+      pages(0),
+      latest(nullptr),
+      previous(nullptr),
+      packet(nullptr),
+      latestStartLine(0),
+      latestDirty(false),
+      previousValid(false),
+      packetLength(0),
+      packetSent(0),
+      sequence(0),
+      lastFrameTime(0),
+      lastKeyframeTime(0),
+      framesSent(0),
+      framesSkipped(0),
+      bytesSent(0),
+      rateWindowStart(0),
+      rateWindowFrames(0),
+      rateWindowBytes(0),
+      frameRate(0),
+      byteRate(0)
+{
+}
+
+FrameMirror::~FrameMirror()
+{
+  free(latest);
+  free(previous);
+  free(packet);
+}
+
+bool FrameMirror::allocate()
+{
+  if (latest)
+    return true;
+
+  width = display.width();
+  pages = min((display.height() + 7) / 8, MAX_PAGES);
+
+  // PackBits paling buruk menambah satu byte control per 128 byte
+  size_t pageWorst = width + (width + 127) / 128;
+  latest = (uint8_t *)malloc(width * pages);
+  previous = (uint8_t *)malloc(width * pages);
+  packet = (uint8_t *)malloc(HEADER_SIZE + pageWorst * pages + 1);
+  if (!latest || !previous || !packet)
+  {
+    Log.println("[Mirror] No memory for frame buffers");
+    free(latest);
+    free(previous);
+    free(packet);
+    latest = previous = packet = nullptr;
+    return false;
+  }
+  return true;
+}
+
+void FrameMirror::setTransport(MirrorTransport mode)
+{
+  if (mode != MIRROR_OFF && !allocate())
+  {
+    mode = MIRROR_OFF;
+  }
+
+  // Stream USB memakai Serial yang sama dengan log; log ditahan selama
+  // stream aktif agar paket tidak tersisip teks
+  if (mode == MIRROR_SERIAL && !Log.isMuted())
+  {
+    Log.println("[Mirror] USB stream on, logging paused");
+    Log.setMuted(true);
+  }
+  else if (mode != MIRROR_SERIAL && Log.isMuted())
+  {
+    Log.setMuted(false);
+    Log.printf("[Mirror] USB stream off, %lu log bytes dropped\n", Log.getDropped());
+  }
+
+  transport = mode;
+  packetLength = 0;
+  packetSent = 0;
+  requestKeyframe();
+
+  if (transport == MIRROR_OFF)
+  {
+    display.setFrameListener(nullptr);
+    return;
+  }
+
+  display.setFrameListener([this](const uint8_t *frame, uint8_t startLine)
+                           { capture(frame, startLine); });
+  // Frame yang sedang tampil dikirim tanpa menunggu render berikutnya
+  capture(display.getBuffer(), 0);
+}
+
+MirrorTransport FrameMirror::getTransport()
+{
+  return transport;
+}
+
+void FrameMirror::requestKeyframe()
+{
+  previousValid = false;
+}
+
+void FrameMirror::capture(const uint8_t *frame, uint8_t startLine)
+{
+  if (!latest || !frame)
+    return;
+
+  if (latestDirty)
+  {
+    framesSkipped++;
+  }
+  memcpy(latest, frame, width * pages);
+  latestStartLine = startLine;
+  latestDirty = true;
+}
+
+void FrameMirror::update()
+{
+  if (transport == MIRROR_OFF || !latest)
+    return;
+
+  updateRate();
+
+  if (transport == MIRROR_BLE && !ble.isConnected())
+  {
+    // Paket setengah jalan hilang, host baru mulai dari keyframe
+    packetLength = 0;
+    packetSent = 0;
+    requestKeyframe();
+    return;
+  }
+
+  if (packetSent < packetLength)
+  {
+    pump();
+    return;
+  }
+
+  unsigned long now = millis();
+  bool keyframeDue = now - lastKeyframeTime >= KEYFRAME_INTERVAL;
+  if (!latestDirty && !keyframeDue)
+    return;
+
+  unsigned long interval = transport == MIRROR_BLE ? BLE_FRAME_INTERVAL : SERIAL_FRAME_INTERVAL;
+  if (now - lastFrameTime < interval)
+    return;
+
+  if (keyframeDue)
+  {
+    requestKeyframe();
+  }
+
+  encodeFrame();
+  latestDirty = false;
+  lastFrameTime = now;
+  pump();
+}
+
+void FrameMirror::encodeFrame()
+{
+  bool keyframe = !previousValid;
+  if (keyframe)
+  {
+    memset(previous, 0, width * pages);
+    lastKeyframeTime = millis();
+  }
+
+  uint8_t *out = packet + HEADER_SIZE;
+  uint16_t pageMask = 0;
+
+  for (int page = 0; page < pages; page++)
+  {
+    uint8_t *prev = previous + page * width;
+    const uint8_t *cur = latest + page * width;
+    if (!keyframe && memcmp(prev, cur, width) == 0)
+      continue;
+
+    // previous dipakai sebagai buffer delta lalu diisi frame baru
+    for (int i = 0; i < width; i++)
+    {
+      prev[i] ^= cur[i];
+    }
+    out += encodePage(prev, out);
+    memcpy(prev, cur, width);
+    pageMask |= 1 << page;
+  }
+  previousValid = true;
+
+  if (pageMask == 0 && !keyframe)
+  {
+    packetLength = 0;
+    packetSent = 0;
+    return;
+  }
+
+  uint16_t length = out - (packet + HEADER_SIZE);
+  packet[0] = 'E';
+  packet[1] = 'M';
+  packet[2] = keyframe ? 1 : 0;
+  packet[3] = sequence++;
+  packet[4] = width;
+  packet[5] = display.height();
+  packet[6] = latestStartLine;
+  packet[7] = pageMask & 0xFF;
+  packet[8] = pageMask >> 8;
+  packet[9] = length & 0xFF;
+  packet[10] = length >> 8;
+
+  uint8_t checksum = 0;
+  for (uint8_t *p = packet + 2; p < out; p++)
+  {
+    checksum += *p;
+  }
+  *out++ = checksum;
+
+  packetLength = out - packet;
+  packetSent = 0;
+  framesSent++;
+  rateWindowFrames++;
+}
+
+size_t FrameMirror::encodePage(const uint8_t *page, uint8_t *out)
+{
+  // PackBits: delta XOR sebagian besar nol, jadi run panjang dominan
+  uint8_t *start = out;
+  int i = 0;
+  while (i < width)
+  {
+    int run = 1;
+    while (i + run < width && run < 128 && page[i + run] == page[i])
+    {
+      run++;
+    }
+
+    if (run >= 2)
+    {
+      *out++ = 257 - run;
+      *out++ = page[i];
+      i += run;
+      continue;
+    }
+
+    // Literal sampai awal run berikutnya (minimal 3 byte sama)
+    int literalStart = i;
+    while (i < width && i - literalStart < 128)
+    {
+      if (i + 2 < width && page[i] == page[i + 1] && page[i] == page[i + 2])
+        break;
+      i++;
+    }
+    int count = i - literalStart;
+    *out++ = count - 1;
+    memcpy(out, page + literalStart, count);
+    out += count;
+  }
+  return out - start;
+}
+
+void FrameMirror::pump()
+{
+  size_t remaining = packetLength - packetSent;
+
+  if (transport == MIRROR_SERIAL)
+  {
+    // Hanya sebanyak ruang buffer TX, sisanya di loop berikutnya
+    int room = Serial.availableForWrite();
+    if (room <= 0)
+      return;
+    size_t count = min(remaining, (size_t)room);
+    Serial.write(packet + packetSent, count);
+    packetSent += count;
+    bytesSent += count;
+    rateWindowBytes += count;
+    return;
+  }
+
+  size_t payload = ble.getMaxPayload();
+  for (int i = 0; i < BLE_BURST && remaining > 0; i++)
+  {
+    size_t count = min(remaining, payload);
+    ble.sendData(packet + packetSent, count);
+    packetSent += count;
+    remaining -= count;
+    bytesSent += count;
+    rateWindowBytes += count;
+  }
+}
+
+void FrameMirror::updateRate()
+{
+  unsigned long now = millis();
+  if (now - rateWindowStart < 1000)
+    return;
+
+  frameRate = rateWindowFrames * 1000 / (now - rateWindowStart);
+  byteRate = rateWindowBytes * 1000 / (now - rateWindowStart);
+  rateWindowStart = now;
+  rateWindowFrames = 0;
+  rateWindowBytes = 0;
+}
+
+unsigned long FrameMirror::getFrameRate()
+{
+  return frameRate;
+}
+
+unsigned long FrameMirror::getByteRate()
+{
+  return byteRate;
+}
+
+unsigned long FrameMirror::getFramesSent()
+{
+  return framesSent;
+}
+
+unsigned long FrameMirror::getFramesSkipped()
+{
+  return framesSkipped;
+}
@@ -0,0 +1,96 @@
+#ifndef FRAME_MIRROR_H
+#define FRAME_MIRROR_H
+
+#include <Arduino.h>
+#include "DisplayManager.h"
+#include "BLEManager.h"
+
+// Stream isi framebuffer ke host lewat USB CDC (Serial) atau notify BLE,
+// didekode oleh tools/mirror_viewer. Format satu paket (little endian):
+//
+//   'E' 'M'            sync
+//   flags              bit0 = keyframe (delta terhadap frame kosong)
+//   seq                nomor urut, naik satu per paket
+//   width, height      ukuran panel
+//   startLine          start line panel (geser vertikal hardware)
+//   pageMask (u16)     page yang ikut dikirim, bit n = page n
+//   length (u16)       panjang payload
+//   payload            tiap page di pageMask: XOR dengan frame sebelumnya,
+//                      dikompres PackBits (control < 128: literal control+1
+//                      byte, selain itu run 257-control byte yang sama)
+//   checksum           jumlah 8-bit byte flags sampai akhir payload
+//
+// Frame yang tidak sempat dikirim tidak antre: delta berikutnya dihitung
+// dari frame terakhir yang terkirim, jadi host selalu konsisten.
+enum MirrorTransport
+{
+  MIRROR_OFF,
+  MIRROR_SERIAL,
+  MIRROR_BLE
+};
+
+class FrameMirror
+{
+private:
+  DisplayManager &display;
+  BLEManager &ble;
+  MirrorTransport transport;
+
+  int width;
+  int pages;
+  uint8_t *latest;   // frame terakhir dari display()
+  uint8_t *previous; // frame terakhir yang terkirim ke host
+  uint8_t *packet;
+  uint8_t latestStartLine;
+  bool latestDirty;
+  bool previousValid;
+
+  size_t packetLength;
+  size_t packetSent;
+  uint8_t sequence;
+  unsigned long lastFrameTime;
+  unsigned long lastKeyframeTime;
+
+  unsigned long framesSent;
+  unsigned long framesSkipped;
+  unsigned long bytesSent;
+  unsigned long rateWindowStart;
+  unsigned long rateWindowFrames;
+  unsigned long rateWindowBytes;
+  unsigned long frameRate;
+  unsigned long byteRate;
+
+  static const int HEADER_SIZE = 11;
+  static const int MAX_PAGES = 16;
+  static const unsigned long SERIAL_FRAME_INTERVAL = 33;
+  static const unsigned long BLE_FRAME_INTERVAL = 100;
+  // Host yang baru terhubung atau kehilangan paket sinkron lagi di sini
+  static const unsigned long KEYFRAME_INTERVAL = 2000;
+  static const int BLE_BURST = 4;
+
+  bool allocate();
+  void encodeFrame();
+  size_t encodePage(const uint8_t *page, uint8_t *out);
+  void pump();
+  void updateRate();
+
+public:
+  FrameMirror(DisplayManager &disp, BLEManager &bleManager);
+  ~FrameMirror();
+
+  void setTransport(MirrorTransport mode);
+  MirrorTransport getTransport();
+  void requestKeyframe();
+
+  // Dipanggil dari listener display(): hanya menyalin buffer
+  void capture(const uint8_t *frame, uint8_t startLine);
+  // Dipanggil dari loop: encode frame terbaru dan kirim tanpa memblokir
+  void update();
+
+  unsigned long getFrameRate();
+  unsigned long getByteRate();
+  unsigned long getFramesSent();
+  unsigned long getFramesSkipped();
+};
+
+#endif
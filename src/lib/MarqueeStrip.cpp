@@ -0,0 +1,122 @@
+#include "MarqueeStrip.h"
+
+MarqueeStrip::MarqueeStrip(DisplayManager &disp)
+    : display(disp),
+      columns(nullptr),
+      capacity(0),
+      loopWidth(0),
+      textWidth(0),
+      offset(0),
+      stepPixels(1),
+      lastStepTime(0)
+{
+}
+
+MarqueeStrip::MarqueeStrip(MarqueeStrip &&other)
+    : display(other.display),
+      columns(other.columns),
+      capacity(other.capacity),
+      loopWidth(other.loopWidth),
+      textWidth(other.textWidth),
+      offset(other.offset),
+      stepPixels(other.stepPixels),
+      lastStepTime(other.lastStepTime)
+{
+  other.columns = nullptr;
+  other.capacity = 0;
+  other.loopWidth = 0;
+  other.textWidth = 0;
+}
+
+MarqueeStrip::~MarqueeStrip()
+{
+  if (columns)
+  {
+    free(columns);
+    columns = nullptr;
+  }
+}
+
+bool MarqueeStrip::setText(const String &text)
+{
+  textWidth = Layout::textWidth(text.length());
+  loopWidth = textWidth + GAP;
+
+  // Buffer hanya dibesarkan, teks yang lebih pendek memakai buffer yang sama
+  if (loopWidth > capacity)
+  {
+    uint8_t *grown = (uint8_t *)realloc(columns, loopWidth);
+    if (!grown)
+    {
+      clear();
+      return false;
+    }
+    columns = grown;
+    capacity = loopWidth;
+  }
+
+  memset(columns, 0, loopWidth);
+  for (unsigned int i = 0; i < text.length(); i++)
+  {
+    memcpy(columns + i * Layout::CHAR_WIDTH, display.getGlyph(text[i]), 5);
+  }
+
+  reset();
+  return true;
+}
+
+void MarqueeStrip::clear()
+{
+  textWidth = 0;
+  loopWidth = 0;
+  reset();
+}
+
+int MarqueeStrip::getTextWidth()
+{
+  return textWidth;
+}
+
+void MarqueeStrip::reset()
+{
+  offset = 0;
+  lastStepTime = millis();
+}
+
+bool MarqueeStrip::update()
+{
+  if (loopWidth == 0)
+    return false;
+
+  unsigned long now = millis();
+  unsigned long stepDelay = STEP_DELAY * stepPixels;
+  unsigned long steps = (now - lastStepTime) / stepDelay;
+  if (steps == 0)
+    return false;
+
+  offset = (offset + steps * stepPixels) % loopWidth;
+  lastStepTime += steps * stepDelay;
+  return true;
+}
+
+void MarqueeStrip::setStepPixels(int pixels)
+{
+  stepPixels = max(1, pixels);
+}
+
+void MarqueeStrip::draw(int16_t x, int16_t y, int16_t width)
+{
+  if (loopWidth == 0 || width <= 0)
+    return;
+
+  // Window bisa melewati akhir strip, sisanya diambil dari awal strip
+  int16_t drawn = 0;
+  int start = offset;
+  while (drawn < width)
+  {
+    int count = min((int)(width - drawn), loopWidth - start);
+    display.drawColumns(x + drawn, y, columns + start, count, SSD1306_WHITE);
+    drawn += count;
+    start = 0;
+  }
+}
@@ -0,0 +1,51 @@
+#ifndef MARQUEE_STRIP_H
+#define MARQUEE_STRIP_H
+
+#include <Arduino.h>
+#include "DisplayManager.h"
+#include "PanelLayout.h"
+
+// Teks berjalan satu baris (font klasik 5x8). Teks dirender sekali ke strip
+// byte kolom saat berubah, lalu tiap frame hanya window pada offset saat ini
+// yang di-blit ke buffer display, dengan wraparound.
+class MarqueeStrip
+{
+private:
+  DisplayManager &display;
+
+  uint8_t *columns;
+  int capacity;
+  int loopWidth;
+  int textWidth;
+
+  int offset;
+  int stepPixels;
+  unsigned long lastStepTime;
+
+public:
+  // Jarak kosong sebelum teks muncul lagi, sama dengan "   " sebelumnya
+  static const int GAP = 18;
+  static const unsigned long STEP_DELAY = 50; // 1 px per 50ms
+
+  MarqueeStrip(DisplayManager &disp);
+  // Strip memiliki buffer columns: tidak boleh disalin, hanya dipindah
+  // (mis. saat array lineMarquees diisi dari temporary)
+  MarqueeStrip(const MarqueeStrip &) = delete;
+  MarqueeStrip &operator=(const MarqueeStrip &) = delete;
+  MarqueeStrip(MarqueeStrip &&other);
+  ~MarqueeStrip();
+
+  bool setText(const String &text);
+  void clear();
+  int getTextWidth();
+
+  void reset();
+  // Geser beberapa piksel per langkah dengan kecepatan sama: lebih sedikit
+  // frame yang berubah, gerakan lebih kasar
+  void setStepPixels(int pixels);
+  // true jika offset bergeser dan strip perlu digambar ulang
+  bool update();
+  void draw(int16_t x, int16_t y, int16_t width);
+};
+
+#endif
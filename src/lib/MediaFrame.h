@@ -0,0 +1,76 @@
+#ifndef MEDIA_FRAME_H
+#define MEDIA_FRAME_H
+
+#include <Arduino.h>
+
+// Frame biner BLE di samping pesan JSON. Byte pertama >= 0x80 sehingga
+// tidak pernah tertukar dengan JSON (selalu diawali '{' atau '"').
+// Frame amplitudo media v1, little endian, 14 byte:
+//
+//   0  type       0x81
+//   1  version    1; versi lebih baru boleh menambah field di belakang
+//   2  sequence   u16, naik satu per frame
+//   4  timestamp  u32, ms menurut jam ponsel
+//   8  amplitude  u16 fixed-point, 65535 = 1.0
+//  10  peak       u16 fixed-point
+//  12  rms        u16 fixed-point
+namespace MediaFrame
+{
+  constexpr uint8_t TYPE_AMPLITUDE = 0x81;
+  constexpr uint8_t VERSION = 1;
+  constexpr size_t AMPLITUDE_SIZE = 14;
+
+  struct Amplitude
+  {
+    uint16_t sequence;
+    uint32_t timestamp;
+    float amplitude;
+    float peak;
+    float rms;
+  };
+
+  inline bool isBinary(const uint8_t *data, size_t length)
+  {
+    return length > 0 && (data[0] & 0x80);
+  }
+
+  inline uint16_t readU16(const uint8_t *p)
+  {
+    return p[0] | (p[1] << 8);
+  }
+
+  inline uint32_t readU32(const uint8_t *p)
+  {
+    return readU16(p) | ((uint32_t)readU16(p + 2) << 16);
+  }
+
+  inline float readUnit(const uint8_t *p)
+  {
+    return readU16(p) * (1.0f / 65535.0f);
+  }
+
+  inline bool decodeAmplitude(const uint8_t *data, size_t length, Amplitude &frame)
+  {
+    if (length < AMPLITUDE_SIZE || data[0] != TYPE_AMPLITUDE || data[1] < VERSION)
+      return false;
+
+    frame.sequence = readU16(data + 2);
+    frame.timestamp = readU32(data + 4);
+    frame.amplitude = readUnit(data + 8);
+    frame.peak = readUnit(data + 10);
+    frame.rms = readUnit(data + 12);
+    return true;
+  }
+
+  // Frame yang sama atau sedikit lebih lama (tertukar urutan) dibuang;
+  // lompatan mundur yang jauh dianggap stream baru dari ponsel
+  constexpr int REORDER_WINDOW = 8;
+
+  inline bool isNewer(uint16_t sequence, uint16_t last)
+  {
+    int16_t delta = sequence - last;
+    return delta > 0 || delta < -REORDER_WINDOW;
+  }
+}
+
+#endif
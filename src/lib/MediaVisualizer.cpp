@@ -1,18 +1,20 @@
 #include "MediaVisualizer.h"
+#include "SerialLog.h"
 
-MediaVisualizer::MediaVisualizer(Adafruit_SSD1306 &disp, FrameRate frameRate)
+MediaVisualizer::MediaVisualizer(DisplayManager &disp, FrameRate frameRate)
     : display(disp),
       currentAmplitude(0),
       peakValue(0),
       rmsValue(0),
       isPlaying(false),
       hasValidMetadata(false),
-      titleScrollPos(0),
-      artistScrollPos(0),
-      lastScrollTime(0),
+      titleMarquee(disp),
+      artistMarquee(disp),
       lastUpdateTime(0),
       lastAmplitudeReceived(0),
       isActive(false),
+      governor(nullptr),
+      appliedLevel(GOVERNOR_FULL),
       targetFrameRate(frameRate)
 {
 
@@ -33,6 +35,8 @@ void MediaVisualizer::begin()
   mediaTitle = "";
   mediaArtist = "";
   mediaStatus = "";
+  titleMarquee.clear();
+  artistMarquee.clear();
   isPlaying = false;
   hasValidMetadata = false;
   isActive = false;
@@ -76,62 +80,32 @@ void MediaVisualizer::drawMetadata()
 
   int availableWidth = SCREEN_WIDTH - TEXT_MARGIN_LEFT - 2;
 
-  if (mediaTitle.length() > 0 && mediaTitle != "Unknown")
+  if (titleMarquee.getTextWidth() > 0)
   {
-    String displayTitle = mediaTitle;
-    int titleWidth = displayTitle.length() * 6;
+    int titleWidth = titleMarquee.getTextWidth();
 
     if (titleWidth > availableWidth)
     {
-      int loopWidth = titleWidth + 18;
-      int xPos = TEXT_MARGIN_LEFT - (titleScrollPos % loopWidth);
-
-      display.setCursor(xPos, 0);
-      display.print(displayTitle + "   ");
-
-      display.setCursor(xPos + loopWidth, 0);
-      display.print(displayTitle + "   ");
-
-      display.fillRect(0, 0, TEXT_MARGIN_LEFT - 1, 9, SSD1306_BLACK);
-
-      if (isPlaying)
-      {
-        display.fillTriangle(2, 2, 2, 8, 7, 5, SSD1306_WHITE);
-      }
-      else
-      {
-        display.fillRect(2, 2, 2, 6, SSD1306_WHITE);
-        display.fillRect(6, 2, 2, 6, SSD1306_WHITE);
-      }
+      titleMarquee.draw(TEXT_MARGIN_LEFT, 0, availableWidth);
     }
     else
     {
       int centerPos = TEXT_MARGIN_LEFT + (availableWidth - titleWidth) / 2;
-      display.setCursor(centerPos, 0);
-      display.print(displayTitle);
+      titleMarquee.draw(centerPos, 0, titleWidth);
     }
   }
 
-  if (mediaArtist.length() > 0 && mediaArtist != "Unknown")
+  if (Layout::MEDIA_HEADER_LINES > 1 && mediaArtist.length() > 0 && mediaArtist != "Unknown")
   {
-    int artistWidth = mediaArtist.length() * 6;
+    int artistWidth = artistMarquee.getTextWidth();
     if (artistWidth > availableWidth)
     {
-      int loopWidth = artistWidth + 18;
-      int xPos = TEXT_MARGIN_LEFT - (artistScrollPos % loopWidth);
-
-      display.setCursor(xPos, 10);
-      display.print(mediaArtist + "   ");
-
-      display.setCursor(xPos + loopWidth, 10);
-      display.print(mediaArtist + "   ");
-
-      display.fillRect(0, 10, TEXT_MARGIN_LEFT - 1, 9, SSD1306_BLACK);
+      artistMarquee.draw(TEXT_MARGIN_LEFT, Layout::LINE_HEIGHT, availableWidth);
     }
     else
     {
       int centerPos = TEXT_MARGIN_LEFT + (availableWidth - artistWidth) / 2;
-      display.setCursor(centerPos, 10);
+      display.setCursor(centerPos, Layout::LINE_HEIGHT);
       display.print(mediaArtist);
     }
   }
@@ -165,13 +139,23 @@ void MediaVisualizer::drawVisualizer()
 
     if (barHeight > 0)
     {
-      display.fillRect(x, y, actualBarWidth, barHeight, SSD1306_WHITE);
+      if (display.isGrayscale())
+      {
+        drawShadedBar(x, y, actualBarWidth, barHeight);
+      }
+      else
+      {
+        display.fillRect(x, y, actualBarWidth, barHeight, SSD1306_WHITE);
+      }
     }
 
     if (peakPositions[i] > 0)
     {
-      int peakY = visualizerYStart + (visualizerHeight - peakPositions[i]);
-      display.drawFastHLine(x, peakY, actualBarWidth, SSD1306_WHITE);
+      if (!governor || governor->allows(GOVERNOR_DROP_PEAKS))
+      {
+        int peakY = visualizerYStart + (visualizerHeight - peakPositions[i]);
+        display.drawFastHLine(x, peakY, actualBarWidth, SSD1306_WHITE);
+      }
 
       if (millis() - peakTimers[i] > 50)
       {
@@ -188,29 +172,73 @@ void MediaVisualizer::drawVisualizer()
   }
 }
 
+void MediaVisualizer::drawShadedBar(int x, int y, int width, int height)
+{
+  // Bagian bawah area visualizer redup, makin tinggi makin terang;
+  // bagian teratas tetap putih mono
+  int visualizerHeight = getVisualizerHeight();
+  int bottom = getVisualizerYStart() + visualizerHeight;
+  int zoneHeight = visualizerHeight / 3;
+
+  int dimTop = max(y, bottom - zoneHeight);
+  display.fillRectGray(x, dimTop, width, bottom - dimTop, 1);
+
+  int midTop = max(y, bottom - zoneHeight * 2);
+  if (midTop < dimTop)
+  {
+    display.fillRectGray(x, midTop, width, dimTop - midTop, 2);
+  }
+
+  if (y < midTop)
+  {
+    display.fillRect(x, y, width, midTop - y, SSD1306_WHITE);
+  }
+}
+
 void MediaVisualizer::updateScrolling()
 {
   if (!hasValidMetadata)
     return;
 
-  unsigned long now = millis();
-  if (now - lastScrollTime >= SCROLL_DELAY)
+  int availableWidth = SCREEN_WIDTH - TEXT_MARGIN_LEFT - 2;
+
+  if (titleMarquee.getTextWidth() > availableWidth)
   {
-    int availableWidth = SCREEN_WIDTH - TEXT_MARGIN_LEFT - 2;
+    titleMarquee.update();
+  }
 
-    int titleWidth = mediaTitle.length() * 6;
-    if (titleWidth > availableWidth)
-    {
-      titleScrollPos += 2;
-    }
+  if (artistMarquee.getTextWidth() > availableWidth)
+  {
+    artistMarquee.update();
+  }
+}
 
-    int artistWidth = mediaArtist.length() * 6;
-    if (artistWidth > availableWidth)
+void MediaVisualizer::updateMarquees(bool titleChanged, bool artistChanged)
+{
+  bool hasTitle = (mediaTitle.length() > 0 && mediaTitle != "Unknown");
+  bool hasArtist = (mediaArtist.length() > 0 && mediaArtist != "Unknown");
+
+  if (Layout::MEDIA_HEADER_LINES == 1)
+  {
+    // Header satu baris: judul dan artis berbagi satu marquee
+    if (titleChanged || artistChanged)
     {
-      artistScrollPos += 2;
+      String line = hasTitle ? mediaTitle : "";
+      if (hasArtist)
+        line += (hasTitle ? " - " : "") + mediaArtist;
+      titleMarquee.setText(line);
     }
+    return;
+  }
+
+  if (titleChanged)
+  {
+    titleMarquee.setText(hasTitle ? mediaTitle : "");
+  }
 
-    lastScrollTime = now;
+  if (artistChanged)
+  {
+    artistMarquee.setText(mediaArtist);
   }
 }
 
@@ -240,9 +268,13 @@ void MediaVisualizer::setFrameRate(FrameRate frameRate)
 {
   targetFrameRate = frameRate;
   updateInterval = 1000 / targetFrameRate;
-  Serial.print("Frame rate set to: ");
-  Serial.print(targetFrameRate);
-  Serial.println(" fps");
+  if (governor)
+  {
+    governor->setFrameInterval(updateInterval);
+  }
+  Log.print("Frame rate set to: ");
+  Log.print(targetFrameRate);
+  Log.println(" fps");
 }
 
 FrameRate MediaVisualizer::getFrameRate()
@@ -250,37 +282,35 @@ FrameRate MediaVisualizer::getFrameRate()
   return targetFrameRate;
 }
 
-void MediaVisualizer::handleMediaData(JsonDocument &doc)
+void MediaVisualizer::handleMediaData(JsonDocument &doc, bool applyAmplitude)
 {
   const char *type = doc["type"];
 
   if (strcmp(type, "media") == 0)
   {
-    String newTitle = doc["title"] | "";
-    String newArtist = doc["artist"] | "";
+    // Dibandingkan langsung dari dokumen; String hanya diisi ulang jika
+    // berubah agar pesan media yang sama tidak menyentuh heap
+    const char *newTitle = doc["title"] | "";
+    const char *newArtist = doc["artist"] | "";
+    const char *newStatus = doc["status"] | "";
 
-    bool titleChanged = (newTitle != mediaTitle);
-    bool artistChanged = (newArtist != mediaArtist);
+    bool titleChanged = mediaTitle != newTitle;
+    bool artistChanged = mediaArtist != newArtist;
 
-    mediaTitle = newTitle;
-    mediaArtist = newArtist;
-    mediaStatus = doc["status"] | "";
+    if (titleChanged)
+      mediaTitle = newTitle;
+    if (artistChanged)
+      mediaArtist = newArtist;
+    if (mediaStatus != newStatus)
+      mediaStatus = newStatus;
     isPlaying = doc["is_playing"] | false;
 
     hasValidMetadata = checkValidMetadata();
 
-    if (titleChanged)
-    {
-      titleScrollPos = 0;
-    }
-
-    if (artistChanged)
-    {
-      artistScrollPos = 0;
-    }
+    updateMarquees(titleChanged, artistChanged);
 
     bool hasAmplitude = false;
-    if (doc["audio_amplitude"].is<JsonObject>())
+    if (applyAmplitude && doc["audio_amplitude"].is<JsonObject>())
     {
       JsonObject audioAmp = doc["audio_amplitude"];
       currentAmplitude = audioAmp["amplitude"] | 0.0f;
@@ -298,12 +328,12 @@ void MediaVisualizer::handleMediaData(JsonDocument &doc)
 
     if (titleChanged || artistChanged)
     {
-      Serial.println("=== Media Updated ===");
-      Serial.println("Title: " + (mediaTitle.length() > 0 ? mediaTitle : "(empty)"));
-      Serial.println("Artist: " + (mediaArtist.length() > 0 ? mediaArtist : "(empty)"));
-      Serial.println("Has Valid Metadata: " + String(hasValidMetadata ? "YES" : "NO"));
-      Serial.println("Mode: " + String(hasValidMetadata ? "WITH METADATA" : "VISUALIZER ONLY"));
-      Serial.println("====================");
+      Log.println("=== Media Updated ===");
+      Log.printf("Title: %s\n", mediaTitle.length() > 0 ? mediaTitle.c_str() : "(empty)");
+      Log.printf("Artist: %s\n", mediaArtist.length() > 0 ? mediaArtist.c_str() : "(empty)");
+      Log.printf("Has Valid Metadata: %s\n", hasValidMetadata ? "YES" : "NO");
+      Log.printf("Mode: %s\n", hasValidMetadata ? "WITH METADATA" : "VISUALIZER ONLY");
+      Log.println("====================");
     }
   }
 }
@@ -322,15 +352,25 @@ void MediaVisualizer::update()
     rmsValue = 0;
   }
 
-  if (now - lastUpdateTime >= updateInterval)
+  unsigned long interval = updateInterval;
+  if (governor)
   {
+    applyGovernorLevel();
+    interval = governor->getFrameInterval();
+  }
+
+  if (now - lastUpdateTime >= interval)
+  {
+    if (governor)
+      governor->beginFrame();
+
     display.clearDisplay();
 
     if (hasValidMetadata)
     {
       drawMetadata();
 
-      display.drawFastHLine(0, 19, SCREEN_WIDTH, SSD1306_WHITE);
+      display.drawFastHLine(0, Layout::MEDIA_SEPARATOR_Y, SCREEN_WIDTH, SSD1306_WHITE);
     }
 
     if (currentAmplitude > 0.01 || peakValue > 0.01)
@@ -355,14 +395,50 @@ void MediaVisualizer::update()
 
     display.display();
     lastUpdateTime = now;
+
+    if (governor)
+      governor->endFrame();
   }
 }
 
+void MediaVisualizer::applyGovernorLevel()
+{
+  if (governor->getLevel() == appliedLevel)
+    return;
+
+  appliedLevel = governor->getLevel();
+  int step = governor->allows(GOVERNOR_COARSE_MARQUEE) ? 1 : 2;
+  titleMarquee.setStepPixels(step);
+  artistMarquee.setStepPixels(step);
+}
+
+void MediaVisualizer::setGovernor(FrameGovernor *frameGovernor)
+{
+  governor = frameGovernor;
+  if (governor)
+  {
+    // Visualizer tidak menggambar tetes keringat
+    static const GovernorLevel MEDIA_STEPS[] = {GOVERNOR_DROP_PEAKS, GOVERNOR_COARSE_MARQUEE, GOVERNOR_HALF_RATE};
+    governor->setSteps(MEDIA_STEPS, 3);
+    governor->setFrameInterval(updateInterval);
+    appliedLevel = -1;
+  }
+}
+
+int MediaVisualizer::getGovernorLevel()
+{
+  return governor ? governor->getLevel() : GOVERNOR_FULL;
+}
+
+void MediaVisualizer::start()
+{
+  isActive = true;
+  lastUpdateTime = 0;
+}
+
 void MediaVisualizer::stop()
 {
   isActive = false;
-  display.clearDisplay();
-  display.display();
 }
 
 bool MediaVisualizer::isVisualizerActive()
@@ -374,6 +450,11 @@ void MediaVisualizer::setAmplitude(float amplitude)
 {
   currentAmplitude = constrain(amplitude, 0.0f, 1.0f);
   lastAmplitudeReceived = millis();
+  // Sama dengan jalur JSON: amplitudo masuk mengaktifkan visualizer
+  if (currentAmplitude > 0.0f)
+  {
+    isActive = true;
+  }
 }
 
 void MediaVisualizer::setPeak(float peak)
@@ -381,9 +462,14 @@ void MediaVisualizer::setPeak(float peak)
   peakValue = constrain(peak, 0.0f, 1.0f);
 }
 
+void MediaVisualizer::setRms(float rms)
+{
+  rmsValue = constrain(rms, 0.0f, 1.0f);
+}
+
 void MediaVisualizer::activateVisualizerOnly()
 {
   hasValidMetadata = false;
   isActive = true;
-  Serial.println("Visualizer activated: FULLSCREEN MODE");
+  Log.println("Visualizer activated: FULLSCREEN MODE");
 }
\ No newline at end of file
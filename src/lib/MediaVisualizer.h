@@ -2,7 +2,10 @@
 #define MEDIA_VISUALIZER_H
 
 #include <Arduino.h>
-#include <Adafruit_SSD1306.h>
+#include "DisplayManager.h"
+#include "MarqueeStrip.h"
+#include "PanelLayout.h"
+#include "FrameGovernor.h"
 #include <ArduinoJson.h>
 
 enum FrameRate
@@ -14,7 +17,7 @@ enum FrameRate
 class MediaVisualizer
 {
 private:
-  Adafruit_SSD1306 &display;
+  DisplayManager &display;
 
   String mediaTitle;
   String mediaArtist;
@@ -34,19 +37,16 @@ private:
   int peakPositions[NUM_BARS];
   unsigned long peakTimers[NUM_BARS];
 
-  int titleScrollPos;
-  int artistScrollPos;
-  unsigned long lastScrollTime;
-  static const unsigned long SCROLL_DELAY = 100;
+  MarqueeStrip titleMarquee;
+  MarqueeStrip artistMarquee;
 
-  const int SCREEN_WIDTH = 128;
-  const int SCREEN_HEIGHT = 64;
-  const int METADATA_HEIGHT = 20;
-  const int VISUALIZER_HEIGHT_WITH_METADATA = 44;
-  const int VISUALIZER_HEIGHT_FULLSCREEN = 64;
-  const int VISUALIZER_Y_START_WITH_METADATA = 20;
-  const int VISUALIZER_Y_START_FULLSCREEN = 0;
-  const int TEXT_MARGIN_LEFT = 12;
+  static constexpr int SCREEN_WIDTH = Layout::WIDTH;
+  static constexpr int SCREEN_HEIGHT = Layout::HEIGHT;
+  static constexpr int VISUALIZER_HEIGHT_WITH_METADATA = Layout::MEDIA_BARS_HEIGHT;
+  static constexpr int VISUALIZER_HEIGHT_FULLSCREEN = Layout::HEIGHT;
+  static constexpr int VISUALIZER_Y_START_WITH_METADATA = Layout::MEDIA_BARS_Y;
+  static constexpr int VISUALIZER_Y_START_FULLSCREEN = 0;
+  static constexpr int TEXT_MARGIN_LEFT = Layout::MEDIA_TEXT_X;
 
   FrameRate targetFrameRate;
   unsigned long updateInterval;
@@ -57,27 +57,40 @@ private:
 
   bool isActive;
 
+  FrameGovernor *governor;
+  int appliedLevel;
+
   bool checkValidMetadata();
   int getVisualizerHeight();
   int getVisualizerYStart();
   void drawMetadata();
   void drawVisualizer();
+  void drawShadedBar(int x, int y, int width, int height);
   void updateScrolling();
+  void updateMarquees(bool titleChanged, bool artistChanged);
   void generateBarTargets();
+  void applyGovernorLevel();
 
 public:
-  MediaVisualizer(Adafruit_SSD1306 &disp, FrameRate frameRate = FPS_30);
+  MediaVisualizer(DisplayManager &disp, FrameRate frameRate = FPS_30);
 
   void begin();
   void setFrameRate(FrameRate frameRate);
   FrameRate getFrameRate();
-  void handleMediaData(JsonDocument &doc);
+  // applyAmplitude false: hanya metadata, amplitudo di dokumen diabaikan
+  void handleMediaData(JsonDocument &doc, bool applyAmplitude = true);
   void update();
+  // Aktif lagi setelah stop(), mis. kembali dari layar sementara dengan
+  // frame snapshot; frame berikutnya langsung dirender
+  void start();
   void stop();
   bool isVisualizerActive();
   void setAmplitude(float amplitude);
   void setPeak(float peak);
+  void setRms(float rms);
   void activateVisualizerOnly();
+  void setGovernor(FrameGovernor *frameGovernor);
+  int getGovernorLevel();
 };
 
 #endif
\ No newline at end of file
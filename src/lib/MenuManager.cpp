@@ -1,6 +1,7 @@
 #include "MenuManager.h"
+#include "SerialLog.h"
 
-MenuManager::MenuManager(Adafruit_SSD1306 &disp)
+MenuManager::MenuManager(DisplayManager &disp)
     : display(disp), selectedIndex(0), scrollOffset(0), isActive(false),
       currentMenu(&mainMenu), currentMenuTitle("Menu")
 {
@@ -9,13 +10,12 @@ MenuManager::MenuManager(Adafruit_SSD1306 &disp)
 
 void MenuManager::begin()
 {
-  Serial.println("[MenuManager] Initialized");
+  Log.println("[MenuManager] Initialized");
 }
 
 int MenuManager::getMaxVisibleItems()
 {
-  int availableHeight = display.height() - MENU_TITLE_HEIGHT - 2;
-  return availableHeight / ITEM_HEIGHT;
+  return Layout::MENU_VISIBLE_ITEMS;
 }
 
 void MenuManager::addItem(const MenuItem &item)
@@ -147,7 +147,7 @@ void MenuManager::show()
   menuTitleStack.clear();
   currentMenuTitle = "Menu";
 
-  Serial.println("[MenuManager] Menu opened");
+  Log.println("[MenuManager] Menu opened");
   drawMenu();
 }
 
@@ -161,10 +161,7 @@ void MenuManager::hide()
   menuStack.clear();
   menuTitleStack.clear();
 
-  display.clearDisplay();
-  display.display();
-
-  Serial.println("[MenuManager] Menu closed");
+  Log.println("[MenuManager] Menu closed");
 }
 
 void MenuManager::update()
@@ -191,8 +188,8 @@ void MenuManager::navigateDown()
     scrollOffset++;
   }
 
-  Serial.print("[MenuManager] Navigate down -> ");
-  Serial.println(selectedIndex);
+  Log.print("[MenuManager] Navigate down -> ");
+  Log.println(selectedIndex);
   drawMenu();
 }
 
@@ -212,8 +209,8 @@ void MenuManager::navigateUp()
     scrollOffset--;
   }
 
-  Serial.print("[MenuManager] Navigate up -> ");
-  Serial.println(selectedIndex);
+  Log.print("[MenuManager] Navigate up -> ");
+  Log.println(selectedIndex);
   drawMenu();
 }
 
@@ -240,8 +237,8 @@ void MenuManager::executeSelectedItem()
 
   MenuItem &item = (*currentMenu)[selectedIndex];
 
-  Serial.print("[MenuManager] Selected: ");
-  Serial.println(item.label);
+  Log.print("[MenuManager] Selected: ");
+  Log.println(item.label);
 
   switch (item.type)
   {
@@ -289,8 +286,8 @@ void MenuManager::enterSubmenu()
     selectedIndex = 0;
     scrollOffset = 0;
 
-    Serial.print("[MenuManager] Enter submenu: ");
-    Serial.println(item.label);
+    Log.print("[MenuManager] Enter submenu: ");
+    Log.println(item.label);
 
     drawMenu();
   }
@@ -322,7 +319,7 @@ void MenuManager::exitMenu()
     selectedIndex = 0;
     scrollOffset = 0;
 
-    Serial.println("[MenuManager] Back to previous menu");
+    Log.println("[MenuManager] Back to previous menu");
     drawMenu();
   }
 }
@@ -335,13 +332,13 @@ void MenuManager::drawMenu()
   display.fillRect(0, 0, display.width(), MENU_TITLE_HEIGHT, SSD1306_WHITE);
   display.setTextColor(SSD1306_BLACK);
   display.setTextSize(1);
-  display.setCursor(2, 2);
+  display.setCursor(2, Layout::MENU_TITLE_Y);
 
   // Truncate title if too long
   String displayTitle = currentMenuTitle;
-  if (displayTitle.length() > 20)
+  if ((int)displayTitle.length() > Layout::MENU_TITLE_CHARS)
   {
-    displayTitle = displayTitle.substring(0, 17) + "...";
+    displayTitle = displayTitle.substring(0, Layout::MENU_TITLE_CHARS - 3) + "...";
   }
   display.print(displayTitle);
 
@@ -350,7 +347,7 @@ void MenuManager::drawMenu()
 
   // Draw menu items
   display.setTextColor(SSD1306_WHITE);
-  int y = MENU_TITLE_HEIGHT + 10;
+  int y = Layout::MENU_FIRST_ITEM_Y;
 
   int startIdx = scrollOffset;
   int endIdx = min(scrollOffset + maxVisibleItems, (int)currentMenu->size());
@@ -398,11 +395,11 @@ void MenuManager::drawMenuItem(int y, const MenuItem &item, bool isSelected)
   // Draw item label
   display.setCursor(LEFT_MARGIN + 8, y);
 
-  // Truncate label if too long (max ~15 chars for 128px width)
+  // Truncate label if too long (15 chars for 128px width)
   String displayLabel = item.label;
-  if (displayLabel.length() > 15)
+  if ((int)displayLabel.length() > Layout::MENU_LABEL_CHARS)
   {
-    displayLabel = displayLabel.substring(0, 12) + "...";
+    displayLabel = displayLabel.substring(0, Layout::MENU_LABEL_CHARS - 3) + "...";
   }
   display.print(displayLabel);
 
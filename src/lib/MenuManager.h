@@ -2,7 +2,8 @@
 #define MENU_MANAGER_H
 
 #include <Arduino.h>
-#include <Adafruit_SSD1306.h>
+#include "DisplayManager.h"
+#include "PanelLayout.h"
 #include <vector>
 
 enum MenuItemType
@@ -29,7 +30,7 @@ struct MenuItem
 class MenuManager
 {
 private:
-  Adafruit_SSD1306 &display;
+  DisplayManager &display;
   std::vector<MenuItem> mainMenu;
   std::vector<MenuItem> *currentMenu;
   std::vector<std::vector<MenuItem> *> menuStack; // Stack untuk navigasi menu
@@ -40,10 +41,10 @@ private:
   int maxVisibleItems;
   bool isActive;
 
-  const int MENU_TITLE_HEIGHT = 12;
-  const int ITEM_HEIGHT = 13;
-  const int LEFT_MARGIN = 2;
-  const int RIGHT_MARGIN = 2;
+  static constexpr int MENU_TITLE_HEIGHT = Layout::MENU_TITLE_HEIGHT;
+  static constexpr int ITEM_HEIGHT = Layout::MENU_ITEM_HEIGHT;
+  static constexpr int LEFT_MARGIN = 2;
+  static constexpr int RIGHT_MARGIN = 2;
 
   String currentMenuTitle;
 
@@ -55,7 +56,7 @@ private:
   int getMaxVisibleItems();
 
 public:
-  MenuManager(Adafruit_SSD1306 &disp);
+  MenuManager(DisplayManager &disp);
 
   void begin();
 
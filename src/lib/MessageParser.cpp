@@ -0,0 +1,278 @@
+#include "MessageParser.h"
+#include "SerialLog.h"
+
+ArenaAllocator::ArenaAllocator()
+    : used(0),
+      peak(0),
+      heapAllocations(0)
+{
+}
+
+bool ArenaAllocator::owns(void *ptr)
+{
+  return ptr >= buffer && ptr < buffer + ARENA_SIZE;
+}
+
+size_t &ArenaAllocator::blockSize(void *ptr)
+{
+  return *(size_t *)((uint8_t *)ptr - ALIGN);
+}
+
+bool ArenaAllocator::isLast(void *ptr)
+{
+  size_t size = (blockSize(ptr) + ALIGN - 1) & ~(ALIGN - 1);
+  return (uint8_t *)ptr + size == buffer + used;
+}
+
+void *ArenaAllocator::allocate(size_t size)
+{
+  size_t total = ALIGN + ((size + ALIGN - 1) & ~(ALIGN - 1));
+  if (used + total > ARENA_SIZE)
+  {
+    heapAllocations++;
+    return malloc(size);
+  }
+
+  uint8_t *ptr = buffer + used + ALIGN;
+  blockSize(ptr) = size;
+  used += total;
+  peak = max(peak, used);
+  return ptr;
+}
+
+void ArenaAllocator::deallocate(void *ptr)
+{
+  if (!ptr)
+    return;
+  if (!owns(ptr))
+  {
+    free(ptr);
+    return;
+  }
+
+  // Blok terakhir bisa dikembalikan; sisanya menunggu reset()
+  if (isLast(ptr))
+  {
+    used = (uint8_t *)ptr - ALIGN - buffer;
+  }
+}
+
+void *ArenaAllocator::reallocate(void *ptr, size_t newSize)
+{
+  if (!ptr)
+    return allocate(newSize);
+  if (!owns(ptr))
+  {
+    heapAllocations++;
+    return realloc(ptr, newSize);
+  }
+
+  size_t oldSize = blockSize(ptr);
+  size_t start = (uint8_t *)ptr - buffer;
+  size_t end = start + ((newSize + ALIGN - 1) & ~(ALIGN - 1));
+
+  // String yang sedang dibangun dan pool yang di-shrink selalu blok
+  // terakhir, jadi cukup geser ujung arena
+  if (isLast(ptr) && end <= ARENA_SIZE)
+  {
+    blockSize(ptr) = newSize;
+    used = end;
+    peak = max(peak, used);
+    return ptr;
+  }
+  if (newSize <= oldSize)
+  {
+    blockSize(ptr) = newSize;
+    return ptr;
+  }
+
+  void *moved = allocate(newSize);
+  if (moved)
+  {
+    memcpy(moved, ptr, oldSize);
+    deallocate(ptr);
+  }
+  return moved;
+}
+
+void ArenaAllocator::reset()
+{
+  used = 0;
+}
+
+size_t ArenaAllocator::getUsed()
+{
+  return used;
+}
+
+size_t ArenaAllocator::getPeak()
+{
+  return peak;
+}
+
+uint32_t ArenaAllocator::getHeapAllocations()
+{
+  return heapAllocations;
+}
+
+MessageParser::MessageParser()
+    : doc(&arena),
+      stats{}
+{
+}
+
+void MessageParser::begin()
+{
+  typeFilter["type"] = true;
+
+  // Field yang dibaca NotificationManager::show() dan toast
+  notificationFilter["type"] = true;
+  notificationFilter["app"] = true;
+  notificationFilter["time"] = true;
+  notificationFilter["texts"] = true;
+
+  // Field yang dibaca MediaVisualizer::handleMediaData()
+  mediaFilter["type"] = true;
+  mediaFilter["title"] = true;
+  mediaFilter["artist"] = true;
+  mediaFilter["status"] = true;
+  mediaFilter["is_playing"] = true;
+  mediaFilter["audio_amplitude"]["amplitude"] = true;
+  mediaFilter["audio_amplitude"]["peak"] = true;
+  mediaFilter["audio_amplitude"]["rms"] = true;
+}
+
+size_t MessageParser::unquote(char *data, size_t length)
+{
+  // Sama dengan jalur String lama: buang kutip pembungkus, lalu \" jadi "
+  if (length >= 1 && data[0] == '"' && data[length - 1] == '"')
+  {
+    length = length >= 2 ? length - 2 : 0;
+    memmove(data, data + 1, length);
+  }
+
+  size_t out = 0;
+  for (size_t i = 0; i < length; i++)
+  {
+    if (data[i] == '\\' && i + 1 < length && data[i + 1] == '"')
+      continue;
+    data[out++] = data[i];
+  }
+  data[out] = '\0';
+  return out;
+}
+
+// Kutip boleh di-escape (\") karena pesan bisa masih terbungkus string JSON
+static const char *skipQuote(const char *p)
+{
+  if (*p == '\\')
+    p++;
+  return *p == '"' ? p + 1 : nullptr;
+}
+
+static const char *skipSpace(const char *p)
+{
+  while (*p == ' ' || *p == '\t' || *p == '\r' || *p == '\n')
+    p++;
+  return p;
+}
+
+const char *MessageParser::findType(const char *data, size_t *typeLength)
+{
+  // Tebakan cepat; kunci "type" di objek bersarang dikoreksi di parse()
+  for (const char *key = strstr(data, "type"); key; key = strstr(key + 4, "type"))
+  {
+    if (key == data || key[-1] != '"')
+      continue;
+
+    const char *p = skipQuote(key + 4);
+    if (!p)
+      continue;
+    p = skipSpace(p);
+    if (*p++ != ':')
+      continue;
+    p = skipQuote(skipSpace(p));
+    if (!p)
+      continue;
+
+    const char *end = strpbrk(p, "\"\\");
+    if (!end)
+      return nullptr;
+    *typeLength = end - p;
+    return p;
+  }
+  return nullptr;
+}
+
+const JsonDocument *MessageParser::filterFor(const char *type, size_t typeLength)
+{
+  if (!type)
+    return nullptr;
+  if (typeLength == 12 && strncmp(type, "notification", 12) == 0)
+    return &notificationFilter;
+  if (typeLength == 5 && strncmp(type, "media", 5) == 0)
+    return &mediaFilter;
+  return nullptr;
+}
+
+DeserializationError MessageParser::deserialize(const char *data, size_t length, const JsonDocument &filter)
+{
+  // Dokumen melepas pool-nya dulu, baru arena dikosongkan
+  doc.clear();
+  arena.reset();
+  return deserializeJson(doc, data, length, DeserializationOption::Filter(filter));
+}
+
+JsonDocument *MessageParser::parse(char *data, size_t length)
+{
+  unsigned long start = micros();
+  uint32_t heapBefore = arena.getHeapAllocations();
+
+  length = unquote(data, length);
+
+  size_t typeLength = 0;
+  const char *type = findType(data, &typeLength);
+  const JsonDocument *filter = filterFor(type, typeLength);
+
+  DeserializationError error = deserialize(data, length, filter ? *filter : typeFilter);
+  if (!error)
+  {
+    // Tebakan type salah: parse ulang dengan filter dari "type" yang benar
+    const char *actual = doc["type"] | "";
+    const JsonDocument *actualFilter = filterFor(actual, strlen(actual));
+    if (actualFilter && actualFilter != filter)
+    {
+      error = deserialize(data, length, *actualFilter);
+    }
+  }
+
+  unsigned long elapsed = micros() - start;
+  stats.messages++;
+  stats.lastBytes = length;
+  stats.lastParseTime = elapsed;
+  stats.maxParseTime = max(stats.maxParseTime, elapsed);
+  stats.lastArenaUsed = arena.getUsed();
+  stats.arenaPeak = arena.getPeak();
+  stats.lastHeapAllocations = arena.getHeapAllocations() - heapBefore;
+  stats.heapAllocations = arena.getHeapAllocations();
+
+  if (stats.lastHeapAllocations > 0)
+  {
+    Log.printf("[JSON] Arena full, %lu heap allocations for %u bytes\n",
+                  (unsigned long)stats.lastHeapAllocations, (unsigned)length);
+  }
+
+  if (error)
+  {
+    stats.errors++;
+    Log.print("[JSON] Parse error: ");
+    Log.println(error.c_str());
+    return nullptr;
+  }
+  return &doc;
+}
+
+ParseStats MessageParser::getStats()
+{
+  return stats;
+}
@@ -0,0 +1,89 @@
+#ifndef MESSAGE_PARSER_H
+#define MESSAGE_PARSER_H
+
+#include <Arduino.h>
+#include <ArduinoJson.h>
+
+// Allocator ArduinoJson di atas buffer tetap. Alokasi hanya menggeser
+// pointer dan reset() mengosongkan semuanya sekaligus; heap baru dipakai
+// (dan dihitung) jika buffer tidak cukup.
+class ArenaAllocator : public ArduinoJson::Allocator
+{
+private:
+  static const size_t ARENA_SIZE = 4096;
+  static const size_t ALIGN = 8;
+
+  // Tiap blok diawali header ukuran agar reallocate() tahu ukuran lamanya
+  alignas(8) uint8_t buffer[ARENA_SIZE];
+  size_t used;
+  size_t peak;
+  uint32_t heapAllocations;
+
+  bool owns(void *ptr);
+  size_t &blockSize(void *ptr);
+  bool isLast(void *ptr);
+
+public:
+  ArenaAllocator();
+
+  void *allocate(size_t size) override;
+  void deallocate(void *ptr) override;
+  void *reallocate(void *ptr, size_t newSize) override;
+
+  // Hanya boleh dipanggil setelah dokumen melepas semua memorinya
+  void reset();
+
+  size_t getUsed();
+  size_t getPeak();
+  uint32_t getHeapAllocations();
+};
+
+struct ParseStats
+{
+  uint32_t messages;
+  uint32_t errors;
+  size_t lastBytes;            // byte JSON yang diparse pada pesan terakhir
+  unsigned long lastParseTime; // us, termasuk unquote dan deteksi type
+  unsigned long maxParseTime;
+  size_t lastArenaUsed;
+  size_t arenaPeak;
+  uint32_t lastHeapAllocations; // alokasi heap saat pesan terakhir
+  uint32_t heapAllocations;     // total sejak boot
+};
+
+// Parse pesan JSON BLE langsung dari slot antrean ke satu JsonDocument yang
+// hidup sepanjang program. Filter dipilih dari nilai "type", sehingga
+// hanya field yang dibaca layar tujuan yang disimpan di dokumen.
+class MessageParser
+{
+private:
+  ArenaAllocator arena;
+  JsonDocument doc;
+
+  // Filter dibuat sekali di begin(), memakai heap biasa
+  JsonDocument typeFilter;
+  JsonDocument notificationFilter;
+  JsonDocument mediaFilter;
+
+  ParseStats stats;
+
+  static size_t unquote(char *data, size_t length);
+  const JsonDocument *filterFor(const char *type, size_t typeLength);
+  DeserializationError deserialize(const char *data, size_t length, const JsonDocument &filter);
+
+public:
+  MessageParser();
+  void begin();
+
+  // data harus diakhiri '\0' dan boleh diubah (unquote dilakukan di
+  // tempat). Hasil valid sampai parse() berikutnya; nullptr jika gagal
+  JsonDocument *parse(char *data, size_t length);
+
+  ParseStats getStats();
+
+  // Nilai "type" tanpa parse penuh, juga untuk pesan yang belum di-unquote.
+  // data harus diakhiri '\0'; nullptr jika tidak ditemukan
+  static const char *findType(const char *data, size_t *typeLength);
+};
+
+#endif
@@ -0,0 +1,113 @@
+#ifndef MESSAGE_QUEUE_H
+#define MESSAGE_QUEUE_H
+
+#include <Arduino.h>
+#include <atomic>
+
+// Ring buffer single-producer/single-consumer dengan slot berukuran tetap,
+// dialokasikan sekali. push() dipanggil dari satu task (mis. callback
+// BLE), front()/pop() dari task lain (loop()). Tanpa lock: producer hanya
+// menulis head, consumer hanya menulis tail.
+template <int Slots, int SlotSize>
+class MessageQueue
+{
+  static_assert((Slots & (Slots - 1)) == 0, "Slots must be a power of two");
+
+private:
+  struct Slot
+  {
+    uint16_t length;
+    char data[SlotSize + 1]; // selalu diakhiri '\0'
+  };
+
+  Slot slots[Slots];
+  std::atomic<uint32_t> head; // jumlah push, ditulis producer
+  std::atomic<uint32_t> tail; // jumlah pop, ditulis consumer
+
+  std::atomic<uint32_t> overflows; // pesan dibuang karena antrean penuh
+  std::atomic<uint32_t> truncated; // pesan dipotong ke SlotSize
+  std::atomic<uint32_t> highWater; // isi antrean tertinggi
+
+public:
+  MessageQueue() : head(0), tail(0), overflows(0), truncated(0), highWater(0) {}
+
+  // Producer. false jika antrean penuh; pesan lama tetap utuh
+  bool push(const uint8_t *data, size_t length)
+  {
+    uint32_t h = head.load(std::memory_order_relaxed);
+    uint32_t t = tail.load(std::memory_order_acquire);
+    if (h - t >= (uint32_t)Slots)
+    {
+      overflows.fetch_add(1, std::memory_order_relaxed);
+      return false;
+    }
+
+    if (length > SlotSize)
+    {
+      truncated.fetch_add(1, std::memory_order_relaxed);
+      length = SlotSize;
+    }
+
+    Slot &slot = slots[h & (Slots - 1)];
+    memcpy(slot.data, data, length);
+    slot.data[length] = '\0';
+    slot.length = length;
+    head.store(h + 1, std::memory_order_release);
+
+    uint32_t used = h + 1 - t;
+    if (used > highWater.load(std::memory_order_relaxed))
+    {
+      highWater.store(used, std::memory_order_relaxed);
+    }
+    return true;
+  }
+
+  // Consumer. Pesan terdepan atau nullptr jika kosong; tetap valid dan
+  // boleh diubah di tempat sampai pop() dipanggil
+  char *front(size_t *length = nullptr)
+  {
+    uint32_t t = tail.load(std::memory_order_relaxed);
+    if (head.load(std::memory_order_acquire) == t)
+      return nullptr;
+
+    Slot &slot = slots[t & (Slots - 1)];
+    if (length)
+      *length = slot.length;
+    return slot.data;
+  }
+
+  // Consumer. Pesan ke-index dari depan (0 = front()) tanpa mengeluarkannya,
+  // nullptr jika index >= size()
+  const char *peek(int index, size_t *length = nullptr)
+  {
+    uint32_t t = tail.load(std::memory_order_relaxed);
+    if (index < 0 || (uint32_t)index >= head.load(std::memory_order_acquire) - t)
+      return nullptr;
+
+    Slot &slot = slots[(t + index) & (Slots - 1)];
+    if (length)
+      *length = slot.length;
+    return slot.data;
+  }
+
+  void pop()
+  {
+    uint32_t t = tail.load(std::memory_order_relaxed);
+    if (head.load(std::memory_order_acquire) != t)
+    {
+      tail.store(t + 1, std::memory_order_release);
+    }
+  }
+
+  int size()
+  {
+    return head.load(std::memory_order_acquire) - tail.load(std::memory_order_acquire);
+  }
+
+  int capacity() { return Slots; }
+  uint32_t getOverflows() { return overflows.load(std::memory_order_relaxed); }
+  uint32_t getTruncated() { return truncated.load(std::memory_order_relaxed); }
+  uint32_t getHighWater() { return highWater.load(std::memory_order_relaxed); }
+};
+
+#endif
@@ -1,18 +1,16 @@
 #include "NotificationManager.h"
+#include "SerialLog.h"
 
-NotificationManager::NotificationManager(Adafruit_SSD1306 &disp, unsigned long duration)
+NotificationManager::NotificationManager(DisplayManager &disp, unsigned long duration)
     : display(disp),
       lineCount(0),
       notificationStartTime(0),
       displayDuration(duration),
       isActive(false),
       hasExpired(false),
-      lastScrollTime(0)
+      appNameMarquee(disp),
+      lineMarquees{MarqueeStrip(disp), MarqueeStrip(disp), MarqueeStrip(disp), MarqueeStrip(disp), MarqueeStrip(disp)}
 {
-  for (int i = 0; i < 5; i++)
-  {
-    scrollPositions[i] = 0;
-  }
 }
 
 void NotificationManager::begin()
@@ -22,22 +20,22 @@ void NotificationManager::begin()
   lineCount = 0;
   isActive = false;
   hasExpired = false;
-  resetScrollPositions();
+  appNameMarquee.clear();
+  for (int i = 0; i < VISIBLE_LINES; i++)
+  {
+    lineMarquees[i].clear();
+  }
 }
 
 void NotificationManager::resetScrollPositions()
 {
-  for (int i = 0; i < 5; i++)
+  appNameMarquee.reset();
+  for (int i = 0; i < VISIBLE_LINES; i++)
   {
-    scrollPositions[i] = 0;
+    lineMarquees[i].reset();
   }
 }
 
-int NotificationManager::getTextWidth(String text)
-{
-  return text.length() * 6;
-}
-
 void NotificationManager::show(JsonDocument &doc)
 {
   const char *app = doc["app"] | "Unknown";
@@ -57,7 +55,7 @@ void NotificationManager::show(const char *app, const char *time, JsonArray text
 
   for (JsonVariant text : texts)
   {
-    if (lineCount >= 5)
+    if (lineCount >= Layout::NOTIF_MAX_LINES)
       break;
 
     const char *textStr = text.as<const char *>();
@@ -68,17 +66,27 @@ void NotificationManager::show(const char *app, const char *time, JsonArray text
     }
   }
 
+  // Teks dirender sekali ke strip, frame berikutnya hanya menggeser window
+  appNameMarquee.setText(appName);
+  for (int i = 0; i < VISIBLE_LINES; i++)
+  {
+    if (i < lineCount)
+      lineMarquees[i].setText(textLines[i]);
+    else
+      lineMarquees[i].clear();
+  }
+
   isActive = true;
   hasExpired = false;
   notificationStartTime = millis();
   resetScrollPositions();
 
-  Serial.println("=== NotificationManager ===");
-  Serial.println("App: " + appName);
-  Serial.println("Time: " + timestamp);
-  Serial.println("Lines: " + String(lineCount));
-  Serial.println("Duration: " + String(displayDuration) + "ms");
-  Serial.println("====================");
+  Log.println("=== NotificationManager ===");
+  Log.println("App: " + appName);
+  Log.println("Time: " + timestamp);
+  Log.println("Lines: " + String(lineCount));
+  Log.println("Duration: " + String(displayDuration) + "ms");
+  Log.println("====================");
 
   update();
 }
@@ -142,27 +150,18 @@ void NotificationManager::drawDefaultIcon()
 
 void NotificationManager::updateScrolling()
 {
-  unsigned long now = millis();
-  if (now - lastScrollTime < SCROLL_DELAY)
-    return;
-
-  for (int i = 0; i < lineCount && i < 5; i++)
+  if (appNameMarquee.getTextWidth() > APP_NAME_WIDTH)
   {
-    int textWidth = getTextWidth(textLines[i]);
-    int availableWidth = SCREEN_WIDTH - 18;
+    appNameMarquee.update();
+  }
 
-    if (textWidth > availableWidth)
+  for (int i = 0; i < lineCount && i < VISIBLE_LINES; i++)
+  {
+    if (lineMarquees[i].getTextWidth() > SCREEN_WIDTH - TEXT_X - 2)
     {
-      scrollPositions[i] += 2;
-
-      if (scrollPositions[i] > textWidth + 12)
-      {
-        scrollPositions[i] = 0;
-      }
+      lineMarquees[i].update();
     }
   }
-
-  lastScrollTime = now;
 }
 
 void NotificationManager::update()
@@ -176,7 +175,7 @@ void NotificationManager::update()
   if (elapsed >= displayDuration)
   {
     hasExpired = true;
-    Serial.println("[NotificationManager] Expired after " + String(elapsed) + "ms");
+    Log.println("[NotificationManager] Expired after " + String(elapsed) + "ms");
     return;
   }
 
@@ -188,58 +187,41 @@ void NotificationManager::update()
   display.setTextColor(SSD1306_WHITE);
   display.setTextWrap(false);
 
-  int appNameWidth = getTextWidth(appName);
-  if (appNameWidth > 96)
+  if (appNameMarquee.getTextWidth() > APP_NAME_WIDTH)
   {
-
-    int xPos = 18 - (scrollPositions[0] % (appNameWidth + 12));
-    display.setCursor(xPos, 0);
-    display.print(appName + "   ");
-    display.setCursor(xPos + appNameWidth + 12, 0);
-    display.print(appName + "   ");
+    appNameMarquee.draw(APP_NAME_X, 0, APP_NAME_WIDTH);
   }
   else
   {
-    display.setCursor(18, 0);
+    display.setCursor(APP_NAME_X, 0);
     display.print(appName);
   }
 
-  if (timestamp.length() > 0)
+  // Hanya bagian jam dari timestamp yang ditampilkan, rata kanan
+  if (timestamp.length() > 11)
   {
     display.setTextSize(1);
-    int timeWidth = timestamp.length() * 6;
-    int timeX = SCREEN_WIDTH - timeWidth - 2;
-    display.setCursor(timeX, 12);
-    display.print(timestamp.substring(11));
+    const char *time = timestamp.c_str() + 11;
+    int timeX = SCREEN_WIDTH - Layout::textWidth(strlen(time)) - 2;
+    display.setCursor(timeX, Layout::NOTIF_TIME_Y);
+    display.print(time);
   }
 
-  display.drawFastHLine(0, 22, SCREEN_WIDTH, SSD1306_WHITE);
+  display.drawFastHLine(0, Layout::NOTIF_SEPARATOR_Y, SCREEN_WIDTH, SSD1306_WHITE);
 
-  int yPos = 26;
-  for (int i = 0; i < lineCount && i < 3; i++)
+  int yPos = Layout::NOTIF_TEXT_Y;
+  for (int i = 0; i < lineCount && i < VISIBLE_LINES; i++)
   {
     if (yPos >= SCREEN_HEIGHT - 8)
       break;
 
-    int textWidth = getTextWidth(textLines[i]);
-    int availableWidth = SCREEN_WIDTH - 4;
-
-    if (textWidth > availableWidth)
+    if (lineMarquees[i].getTextWidth() > SCREEN_WIDTH - TEXT_X - 2)
     {
-
-      int loopWidth = textWidth + 18;
-      int xPos = 2 - (scrollPositions[i + 1] % loopWidth);
-
-      display.setCursor(xPos, yPos);
-      display.print(textLines[i] + "   ");
-
-      display.setCursor(xPos + loopWidth, yPos);
-      display.print(textLines[i] + "   ");
+      lineMarquees[i].draw(TEXT_X, yPos, SCREEN_WIDTH - TEXT_X);
     }
     else
     {
-
-      display.setCursor(2, yPos);
+      display.setCursor(TEXT_X, yPos);
       display.print(textLines[i]);
     }
 
@@ -247,7 +229,7 @@ void NotificationManager::update()
   }
 
   int progressWidth = map(elapsed, 0, displayDuration, 0, SCREEN_WIDTH);
-  display.drawFastHLine(0, SCREEN_HEIGHT - 2, progressWidth, SSD1306_WHITE);
+  display.drawFastHLine(0, Layout::NOTIF_PROGRESS_Y, progressWidth, SSD1306_WHITE);
 
   updateScrolling();
 
@@ -261,7 +243,7 @@ void NotificationManager::dismiss()
   hasExpired = true;
   display.clearDisplay();
   display.display();
-  Serial.println("[NotificationManager] Dismissed manually");
+  Log.println("[NotificationManager] Dismissed manually");
 }
 
 bool NotificationManager::isExpired()
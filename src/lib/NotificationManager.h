@@ -2,32 +2,37 @@
 #define NOTIFICATION_MANAGER_H
 
 #include <Arduino.h>
-#include <Adafruit_SSD1306.h>
+#include "DisplayManager.h"
+#include "MarqueeStrip.h"
+#include "PanelLayout.h"
 #include <ArduinoJson.h>
 
 class NotificationManager
 {
 private:
-  Adafruit_SSD1306 &display;
+  DisplayManager &display;
 
   String appName;
   String timestamp;
-  String textLines[5];
+  String textLines[Layout::NOTIF_MAX_LINES];
   int lineCount;
 
-  const int SCREEN_WIDTH = 128;
-  const int SCREEN_HEIGHT = 64;
-  const int LINE_HEIGHT = 10;
-  const int MAX_CHARS_PER_LINE = 21;
+  static constexpr int SCREEN_WIDTH = Layout::WIDTH;
+  static constexpr int SCREEN_HEIGHT = Layout::HEIGHT;
+  static constexpr int LINE_HEIGHT = Layout::LINE_HEIGHT;
+  static constexpr int MAX_CHARS_PER_LINE = Layout::charsFitting(Layout::WIDTH - 2);
 
   unsigned long notificationStartTime;
   unsigned long displayDuration;
   bool isActive;
   bool hasExpired;
 
-  int scrollPositions[5];
-  unsigned long lastScrollTime;
-  static const unsigned long SCROLL_DELAY = 100;
+  static constexpr int VISIBLE_LINES = Layout::NOTIF_VISIBLE_LINES;
+  static constexpr int APP_NAME_X = Layout::NOTIF_APP_X;
+  static constexpr int APP_NAME_WIDTH = Layout::NOTIF_APP_WIDTH;
+  static constexpr int TEXT_X = Layout::NOTIF_TEXT_X;
+  MarqueeStrip appNameMarquee;
+  MarqueeStrip lineMarquees[Layout::NOTIF_MAX_LINES];
 
   void drawAppIcon(const char *app);
   void drawWhatsAppIcon();
@@ -37,10 +42,9 @@ private:
 
   void resetScrollPositions();
   void updateScrolling();
-  int getTextWidth(String text);
 
 public:
-  NotificationManager(Adafruit_SSD1306 &disp, unsigned long duration = 15000);
+  NotificationManager(DisplayManager &disp, unsigned long duration = 15000);
 
   void begin();
   void show(JsonDocument &doc);
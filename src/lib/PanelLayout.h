@@ -0,0 +1,150 @@
+#ifndef PANEL_LAYOUT_H
+#define PANEL_LAYOUT_H
+
+// Ukuran dan jenis panel, diganti lewat build flag. Contoh:
+//   128x32 SSD1306 : -DPANEL_HEIGHT=32
+//   128x128 SSD1327: -DPANEL_HEIGHT=128 -DPANEL_SSD1327=1
+#ifndef PANEL_WIDTH
+#define PANEL_WIDTH 128
+#endif
+
+#ifndef PANEL_HEIGHT
+#define PANEL_HEIGHT 64
+#endif
+
+// SSD1327: grayscale 4-bit native, dikirim dari page buffer + plane abu-abu
+#ifndef PANEL_SSD1327
+#define PANEL_SSD1327 0
+#endif
+
+#ifndef PANEL_ADDRESS
+#if PANEL_SSD1327
+#define PANEL_ADDRESS 0x3D
+#else
+#define PANEL_ADDRESS 0x3C
+#endif
+#endif
+
+// Modul SSD1306 SPI 4-wire (-DPANEL_SPI=1). Clock maksimum SSD1306 10 MHz.
+// Default pin mengikuti SPI bawaan ESP32-C3 (SCK 4, MOSI 6, CS 7).
+#ifndef PANEL_SPI
+#define PANEL_SPI 0
+#endif
+
+#ifndef PANEL_SPI_SCK
+#define PANEL_SPI_SCK 4
+#endif
+
+#ifndef PANEL_SPI_MOSI
+#define PANEL_SPI_MOSI 6
+#endif
+
+#ifndef PANEL_SPI_DC
+#define PANEL_SPI_DC 5
+#endif
+
+#ifndef PANEL_SPI_CS
+#define PANEL_SPI_CS 7
+#endif
+
+#ifndef PANEL_SPI_RST
+#define PANEL_SPI_RST -1
+#endif
+
+#ifndef PANEL_SPI_CLOCK
+#define PANEL_SPI_CLOCK 10000000UL
+#endif
+
+// Dua panel SSD1306 pada bus I2C yang sama (alamat PANEL_ADDRESS dan
+// PANEL_ADDRESS_2), dipilih lewat -DDUAL_PANEL=<mode>:
+//   DUAL_PANEL_MIRROR: panel kedua menampilkan salinan frame panel pertama;
+//                      layar mata menggambar satu mata, jadi tiap panel satu mata
+//   DUAL_PANEL_SPLIT : mata digambar di satu kanvas selebar dua panel
+#define DUAL_PANEL_MIRROR 1
+#define DUAL_PANEL_SPLIT 2
+
+#ifndef DUAL_PANEL
+#define DUAL_PANEL 0
+#endif
+
+#ifndef PANEL_ADDRESS_2
+#define PANEL_ADDRESS_2 0x3D
+#endif
+
+#if DUAL_PANEL && PANEL_SSD1327
+#error "DUAL_PANEL hanya untuk panel SSD1306"
+#endif
+
+#if PANEL_SPI && (PANEL_SSD1327 || DUAL_PANEL)
+#error "PANEL_SPI hanya untuk satu panel SSD1306"
+#endif
+
+// Region layar yang dihitung dari ukuran panel saat compile. Nilai untuk
+// 128x64 sama dengan layout lama; panel 32 baris memakai header satu baris.
+namespace Layout
+{
+  constexpr int WIDTH = PANEL_WIDTH;
+  constexpr int HEIGHT = PANEL_HEIGHT;
+  constexpr bool COMPACT = HEIGHT < 64;
+
+  // Font klasik 5x7 dengan spasi satu kolom
+  constexpr int CHAR_WIDTH = 6;
+  constexpr int CHAR_HEIGHT = 8;
+  constexpr int LINE_HEIGHT = 10;
+
+  constexpr int textWidth(int length) { return length * CHAR_WIDTH; }
+  constexpr int charsFitting(int width) { return width / CHAR_WIDTH; }
+
+  // Media: judul dan artis di header, garis pemisah, lalu area bar
+  constexpr int MEDIA_HEADER_LINES = COMPACT ? 1 : 2;
+  constexpr int MEDIA_HEADER_HEIGHT = MEDIA_HEADER_LINES * LINE_HEIGHT;
+  constexpr int MEDIA_SEPARATOR_Y = MEDIA_HEADER_HEIGHT - 1;
+  constexpr int MEDIA_TEXT_X = 12;
+  constexpr int MEDIA_BARS_Y = MEDIA_HEADER_HEIGHT;
+  constexpr int MEDIA_BARS_HEIGHT = HEIGHT - MEDIA_HEADER_HEIGHT;
+
+  // Notifikasi: ikon 16 piksel dan nama app, jam di bawahnya (atau di
+  // kanan nama app pada panel kecil), teks, progress di baris bawah
+  constexpr int NOTIF_ICON_SIZE = 16;
+  constexpr int NOTIF_APP_X = 18;
+  constexpr int NOTIF_TIME_Y = COMPACT ? 0 : 12;
+  constexpr int NOTIF_TIME_CHARS = 8; // "HH:MM:SS"
+  constexpr int NOTIF_APP_WIDTH = WIDTH - NOTIF_APP_X - (COMPACT ? textWidth(NOTIF_TIME_CHARS) + 4 : 0);
+  constexpr int NOTIF_SEPARATOR_Y = COMPACT ? NOTIF_ICON_SIZE - 1 : 22;
+  constexpr int NOTIF_TEXT_X = 2;
+  constexpr int NOTIF_TEXT_Y = NOTIF_SEPARATOR_Y + (COMPACT ? 2 : 4);
+  constexpr int NOTIF_PROGRESS_Y = HEIGHT - 2;
+  constexpr int NOTIF_MAX_LINES = 5;
+  constexpr int NOTIF_FITTING_LINES = (NOTIF_PROGRESS_Y - NOTIF_TEXT_Y) / LINE_HEIGHT;
+  constexpr int NOTIF_VISIBLE_LINES = NOTIF_FITTING_LINES < NOTIF_MAX_LINES ? NOTIF_FITTING_LINES : NOTIF_MAX_LINES;
+
+  // Toast: strip satu baris teks di bawah layar, di atas layer mata
+  constexpr int TOAST_HEIGHT = LINE_HEIGHT + 2;
+  constexpr int TOAST_Y = HEIGHT - TOAST_HEIGHT;
+  constexpr int TOAST_TEXT_X = 2;
+  constexpr int TOAST_TEXT_Y = TOAST_Y + 3;
+
+  // Menu: title bar, item dengan nilai rata kanan
+  constexpr int MENU_TITLE_HEIGHT = COMPACT ? 10 : 12;
+  constexpr int MENU_TITLE_Y = COMPACT ? 1 : 2;
+  constexpr int MENU_ITEM_HEIGHT = COMPACT ? 10 : 13;
+  constexpr int MENU_FIRST_ITEM_Y = MENU_TITLE_HEIGHT + (COMPACT ? 2 : 10);
+  constexpr int MENU_VISIBLE_ITEMS = (HEIGHT - MENU_FIRST_ITEM_Y - CHAR_HEIGHT) / MENU_ITEM_HEIGHT + 1;
+  constexpr int MENU_TITLE_CHARS = charsFitting(WIDTH - 4);
+  constexpr int MENU_LABEL_CHARS = charsFitting(WIDTH - 38);
+
+  // Kanvas mata: dua panel berdampingan pada mode split
+  constexpr bool SPLIT_EYES = DUAL_PANEL == DUAL_PANEL_SPLIT;
+  constexpr int EYE_CANVAS_WIDTH = SPLIT_EYES ? WIDTH * 2 : WIDTH;
+
+  // Ukuran mata: tinggi mengikuti tinggi panel (maks. 64, batas renderer
+  // analitik), lebar sedikit melebar di panel tinggi dan dua kali lipat
+  // di kanvas split
+  constexpr int EYE_SCALE_Y = HEIGHT > 112 ? 112 : HEIGHT;
+  constexpr int EYE_SCALE_X = SPLIT_EYES ? 128 : (HEIGHT > 64 ? 80 : 64);
+
+  constexpr int eyeHeight(int size) { return size * EYE_SCALE_Y / 64; }
+  constexpr int eyeWidth(int size) { return size * EYE_SCALE_X / 64; }
+}
+
+#endif
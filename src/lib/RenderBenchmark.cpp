@@ -0,0 +1,225 @@
+#include "RenderBenchmark.h"
+#include "FluxGarage_RoboEyes.h"
+#include "PanelLayout.h"
+#include "SerialLog.h"
+
+RenderBenchmark::RenderBenchmark(DisplayManager &disp)
+    : display(disp)
+{
+}
+
+void RenderBenchmark::drawEyesScene()
+{
+  // Sama dengan frame RoboEyes: dua mata, kelopak tired dan potongan happy
+  display.clearDisplay();
+  display.fillRoundRect(25, 14, 36, 36, 8, SSD1306_WHITE);
+  display.fillRoundRect(71, 14, 36, 36, 8, SSD1306_WHITE);
+  display.fillTriangle(25, 13, 61, 13, 25, 31, SSD1306_BLACK);
+  display.fillTriangle(71, 13, 107, 13, 107, 31, SSD1306_BLACK);
+  display.fillRoundRect(24, 33, 38, 36, 8, SSD1306_BLACK);
+  display.fillRoundRect(70, 33, 38, 36, 8, SSD1306_BLACK);
+}
+
+void RenderBenchmark::drawVisualizerScene(int phase)
+{
+  // 16 bar ala MediaVisualizer dengan penanda peak
+  display.clearDisplay();
+  display.drawFastHLine(0, 19, 128, SSD1306_WHITE);
+  for (int i = 0; i < 16; i++)
+  {
+    int barHeight = 8 + (i * 7 + phase) % 36;
+    int x = i * 8;
+    display.fillRect(x, 64 - barHeight, 7, barHeight, SSD1306_WHITE);
+    display.drawFastHLine(x, 62 - barHeight, 7, SSD1306_WHITE);
+  }
+}
+
+void RenderBenchmark::drawChromeScene()
+{
+  // Bingkai notifikasi dan menu tanpa teks
+  display.clearDisplay();
+  display.fillRoundRect(2, 2, 12, 10, 2, SSD1306_WHITE);
+  display.fillTriangle(12, 10, 14, 12, 12, 12, SSD1306_WHITE);
+  display.drawFastHLine(4, 5, 6, SSD1306_BLACK);
+  display.drawFastHLine(4, 8, 6, SSD1306_BLACK);
+  display.drawFastHLine(0, 22, 128, SSD1306_WHITE);
+  display.drawFastHLine(0, 62, 96, SSD1306_WHITE);
+  display.fillRect(0, 0, 128, 12, SSD1306_WHITE);
+  display.fillTriangle(120, 60, 124, 60, 122, 62, SSD1306_WHITE);
+}
+
+void RenderBenchmark::drawTextScene()
+{
+  // Notifikasi tiga baris dan item menu dengan highlight
+  display.clearDisplay();
+  display.setTextSize(1);
+  display.setTextWrap(false);
+  display.setTextColor(SSD1306_WHITE);
+  display.setCursor(18, 3);
+  display.print("WhatsApp");
+  display.setCursor(0, 26);
+  display.print("Budi: nanti jam 7 jadi");
+  display.setCursor(0, 37);
+  display.print("ketemu di depan kampus?");
+  display.setCursor(0, 48);
+  display.print("Kabari kalau berangkat");
+  display.setTextColor(SSD1306_BLACK, SSD1306_WHITE);
+  display.setCursor(4, 13);
+  display.print("> Connectivity      ");
+  display.setTextColor(SSD1306_WHITE);
+}
+
+unsigned long RenderBenchmark::timeScenes(bool fastRaster)
+{
+  bool previous = display.isFastRaster();
+  display.setFastRaster(fastRaster);
+
+  unsigned long start = micros();
+  for (int i = 0; i < RASTER_ITERATIONS; i++)
+  {
+    drawEyesScene();
+    drawVisualizerScene();
+    drawChromeScene();
+    drawTextScene();
+  }
+  unsigned long elapsed = micros() - start;
+
+  display.setFastRaster(previous);
+  return elapsed / RASTER_ITERATIONS;
+}
+
+void RenderBenchmark::runRasterBenchmark()
+{
+  // Benchmark tidak boleh menimpa buffer yang sedang dikirim
+  display.waitForFlush();
+
+  unsigned long stockTime = timeScenes(false);
+  unsigned long fastTime = timeScenes(true);
+
+  Log.println("=== Raster Benchmark ===");
+  Log.printf("Scenes: eyes + visualizer + chrome + text, %d iterations\n", RASTER_ITERATIONS);
+  Log.printf("Stock GFX : %lu us/frame set\n", stockTime);
+  Log.printf("Page-native: %lu us/frame set\n", fastTime);
+  if (fastTime > 0)
+  {
+    Log.printf("Speedup   : %.2fx\n", (float)stockTime / fastTime);
+  }
+  Log.println("========================");
+}
+
+template <typename Eyes>
+unsigned long RenderBenchmark::timeEyeFrames(Eyes &eyes)
+{
+  // Urutan animasi sama untuk kedua instansiasi
+  randomSeed(1);
+  eyes.begin(display.width(), display.height(), 100);
+  eyes.setAnalyticRenderer(ON);
+  eyes.setAutoblinker(ON, 1, 1);
+  eyes.setIdleMode(ON, 1, 1);
+  eyes.setMood(TIRED);
+
+  unsigned long total = 0;
+  for (int i = 0; i < EYE_FRAMES; i++)
+  {
+    // Tunggu flush di luar pengukuran, yang diukur hanya render + salin buffer
+    display.waitForFlush();
+    unsigned long start = micros();
+    eyes.drawEyes();
+    total += micros() - start;
+  }
+
+  // RNG global dipakai juga oleh pet (gaze, timer idle, motor)
+  randomSeed(esp_random());
+  return total / EYE_FRAMES;
+}
+
+void RenderBenchmark::runEyeGeometryBenchmark()
+{
+  RoboEyes<DisplayManager> generic(display);
+  RoboEyes<DisplayManager, PANEL_WIDTH, PANEL_HEIGHT> fixed(display);
+
+  unsigned long genericTime = timeEyeFrames(generic);
+  unsigned long fixedTime = timeEyeFrames(fixed);
+
+  Log.println("=== Eye Geometry Benchmark ===");
+  Log.printf("Frames: %d, async flush: %s\n", EYE_FRAMES, display.isAsyncFlush() ? "on" : "off");
+  Log.printf("Generic <W,H runtime>: %lu us/frame, %u bytes\n", genericTime, (unsigned)sizeof(generic));
+  Log.printf("Fixed   <%d,%d>     : %lu us/frame, %u bytes\n", PANEL_WIDTH, PANEL_HEIGHT, fixedTime, (unsigned)sizeof(fixed));
+  if (fixedTime > 0)
+  {
+    Log.printf("Speedup : %.2fx\n", (float)genericTime / fixedTime);
+  }
+  Log.println("Flash: bandingkan ukuran firmware dengan/tanpa -DROBOEYES_FIXED_GEOMETRY");
+  Log.println("==============================");
+}
+
+template <typename Render>
+void RenderBenchmark::timePacedFrames(const char *name, Render render)
+{
+  display.waitForFlush();
+  display.resetFlushStats();
+
+  unsigned long renderTotal = 0;
+  unsigned long frameTotal = 0;
+  unsigned long flushTotal = 0;
+  unsigned long flushMax = 0;
+  int late = 0;
+
+  unsigned long next = micros();
+  for (int i = 0; i < PACED_FRAMES; i++)
+  {
+    while ((long)(micros() - next) < 0)
+      ;
+    next += PACED_FRAME_US;
+
+    // render() diakhiri display(); frame dihitung sampai transfer selesai
+    unsigned long start = micros();
+    render(i);
+    renderTotal += micros() - start;
+    display.waitForFlush();
+    unsigned long frameTime = micros() - start;
+
+    unsigned long flushTime = display.getFlushStats().lastFlushTime;
+    frameTotal += frameTime;
+    flushTotal += flushTime;
+    if (flushTime > flushMax)
+      flushMax = flushTime;
+    if (frameTime > PACED_FRAME_US)
+      late++;
+  }
+
+  FlushStats stats = display.getFlushStats();
+  Log.printf("%-10s: render %lu us, flush %lu us (max %lu), frame %lu us, %d/%d late, %lu B/frame\n",
+                name, renderTotal / PACED_FRAMES, flushTotal / PACED_FRAMES, flushMax,
+                frameTotal / PACED_FRAMES, late, PACED_FRAMES, stats.bytesSent / PACED_FRAMES);
+}
+
+void RenderBenchmark::runFrameTimeBenchmark()
+{
+  RoboEyes<DisplayManager> eyes(display);
+  randomSeed(1);
+  eyes.begin(display.width(), display.height(), 60);
+  eyes.setAnalyticRenderer(ON);
+  eyes.setAutoblinker(ON, 1, 1);
+  eyes.setIdleMode(ON, 1, 1);
+
+  Log.println("=== Frame Time Benchmark (60 fps) ===");
+  Log.printf("Bus: %s %lu kHz, %d frames per scene\n", display.isSpi() ? "SPI" : "I2C",
+                (unsigned long)(display.getBusClock() / 1000), PACED_FRAMES);
+
+  // drawEyes() sudah memanggil display()
+  timePacedFrames("RoboEyes", [&](int)
+                  { eyes.invalidateFrame(); eyes.drawEyes(); });
+  timePacedFrames("Visualizer", [&](int frame)
+                  { drawVisualizerScene(frame);
+                    display.display(); });
+
+  // Frame penuh: shadow dibuang sehingga seluruh buffer dikirim
+  timePacedFrames("Full frame", [&](int frame)
+                  { drawVisualizerScene(frame);
+                    display.invalidate();
+                    display.display(); });
+
+  randomSeed(esp_random());
+  Log.println("=====================================");
+}
@@ -0,0 +1,40 @@
+#ifndef RENDER_BENCHMARK_H
+#define RENDER_BENCHMARK_H
+
+#include <Arduino.h>
+#include "DisplayManager.h"
+
+// Benchmark render on-device, hasil dicetak ke Serial.
+// Semua benchmark hanya menggambar ke buffer (tanpa flush) dan
+// meninggalkan buffer kotor, screen aktif akan menggambar ulang.
+class RenderBenchmark
+{
+private:
+  DisplayManager &display;
+
+  static const int RASTER_ITERATIONS = 50;
+  static const int EYE_FRAMES = 200;
+  static const int PACED_FRAMES = 120;
+  static const unsigned long PACED_FRAME_US = 1000000UL / 60;
+
+  void drawEyesScene();
+  void drawVisualizerScene(int phase = 0);
+  void drawChromeScene();
+  void drawTextScene();
+  unsigned long timeScenes(bool fastRaster);
+  template <typename Eyes>
+  unsigned long timeEyeFrames(Eyes &eyes);
+  template <typename Render>
+  void timePacedFrames(const char *name, Render render);
+
+public:
+  RenderBenchmark(DisplayManager &disp);
+
+  void runRasterBenchmark();
+  void runEyeGeometryBenchmark();
+  // Render + flush pada 60 fps lewat bus saat ini (I2C atau SPI);
+  // jalankan di kedua build untuk membandingkan transport
+  void runFrameTimeBenchmark();
+};
+
+#endif
@@ -2,22 +2,46 @@
 #define ROBOT_PET_H
 
 #include <Arduino.h>
-#include <Adafruit_SSD1306.h>
+#include "DisplayManager.h"
+#include "DualDisplay.h"
+#include "PanelLayout.h"
+#include "FrameGovernor.h"
 #include <lib/FluxGarage_RoboEyes.h>
 #include "SoundPlayer.h"
 #include "MotorManager.h"
+#include "SerialLog.h"
+
+// Mode split: mata digambar di kanvas gabungan dua panel
+#if DUAL_PANEL == DUAL_PANEL_SPLIT
+typedef DualDisplay EyeDisplay;
+#else
+typedef DisplayManager EyeDisplay;
+#endif
+
+// Build flag -DROBOEYES_FIXED_GEOMETRY: ukuran panel jadi konstanta compile-time
+#ifdef ROBOEYES_FIXED_GEOMETRY
+typedef RoboEyes<EyeDisplay, Layout::EYE_CANVAS_WIDTH, PANEL_HEIGHT> PetEyes;
+#else
+typedef RoboEyes<EyeDisplay> PetEyes;
+#endif
 
 class RobotPet
 {
 private:
-  Adafruit_SSD1306 &display;
-  RoboEyes<Adafruit_SSD1306> roboEyes;
+  EyeDisplay &display;
+  PetEyes roboEyes;
   SoundPlayer &melody;
   MotorManager &motor;
 
   int screenWidth, screenHeight, refreshDelay;
   bool isRunning;
 
+  // Degradasi efek saat frame melewati budget; sweat diingat agar bisa
+  // dinyalakan lagi setelah level turun
+  FrameGovernor *governor;
+  int appliedLevel;
+  bool sweatWanted;
+
   enum EyeState
   {
     Default,
@@ -39,6 +63,12 @@ private:
   static const unsigned long SCARE_DURATION = 4000;
   static const unsigned long SCARED_DURATION = 2000;
 
+  // Tiap slot sprite mata memakai sizeof(EyeSprite) = 544 byte RAM
+  // (512 byte kolom + key, used dan lastUse)
+  static const byte EYE_SPRITE_SLOTS = 4;
+  // Level abu-abu tepi mata saat display dalam mode grayscale
+  static const uint8_t EYE_EDGE_LEVEL = 1;
+
   unsigned long lastActionTime;
   unsigned long lastMotorActionTime;
   unsigned long randomMotorInterval;
@@ -50,19 +80,35 @@ private:
   int leftCount;
   int rightCount;
 
+  void setSweat(bool on)
+  {
+    sweatWanted = on;
+    roboEyes.setSweat(on && (!governor || governor->allows(GOVERNOR_DROP_SWEAT)));
+  }
+
+  void applyGovernorLevel()
+  {
+    if (governor->getLevel() == appliedLevel)
+      return;
+
+    appliedLevel = governor->getLevel();
+    setSweat(sweatWanted);
+    roboEyes.setFramerate(1000 / governor->getFrameInterval());
+  }
+
   void setDefaultState()
   {
     roboEyes.setMood(DEFAULT);
-    roboEyes.setWidth(30, 30);
-    roboEyes.setHeight(36, 36);
-    roboEyes.setSpacebetween(16);
-    roboEyes.setBorderradius(6, 6);
+    roboEyes.setWidth(Layout::eyeWidth(30), Layout::eyeWidth(30));
+    roboEyes.setHeight(Layout::eyeHeight(36), Layout::eyeHeight(36));
+    roboEyes.setSpacebetween(Layout::eyeWidth(16));
+    roboEyes.setBorderradius(Layout::eyeHeight(6), Layout::eyeHeight(6));
     roboEyes.setPosition(DEFAULT);
     roboEyes.setAutoblinker(ON, 2, 2);
     roboEyes.setIdleMode(OFF);
     roboEyes.setHFlicker(OFF);
     roboEyes.setVFlicker(OFF);
-    roboEyes.setSweat(OFF);
+    setSweat(OFF);
     roboEyes.setCuriosity(OFF);
   }
 
@@ -76,84 +122,84 @@ private:
   {
     currentEyeState = Happy;
     roboEyes.setMood(HAPPY);
-    roboEyes.setWidth(32, 32);
-    roboEyes.setHeight(36, 36);
-    roboEyes.setBorderradius(8, 8);
+    roboEyes.setWidth(Layout::eyeWidth(32), Layout::eyeWidth(32));
+    roboEyes.setHeight(Layout::eyeHeight(36), Layout::eyeHeight(36));
+    roboEyes.setBorderradius(Layout::eyeHeight(8), Layout::eyeHeight(8));
     roboEyes.anim_laugh();
     roboEyes.setIdleMode(OFF);
     roboEyes.setAutoblinker(OFF);
-    Serial.println("CurrentState: Happy");
+    Log.println("CurrentState: Happy");
   }
 
   void enterLongHappyState()
   {
     currentEyeState = LongHappy;
     roboEyes.setMood(HAPPY);
-    roboEyes.setWidth(32, 32);
-    roboEyes.setHeight(36, 36);
-    roboEyes.setBorderradius(8, 8);
+    roboEyes.setWidth(Layout::eyeWidth(32), Layout::eyeWidth(32));
+    roboEyes.setHeight(Layout::eyeHeight(36), Layout::eyeHeight(36));
+    roboEyes.setBorderradius(Layout::eyeHeight(8), Layout::eyeHeight(8));
     roboEyes.setVFlicker(ON, 5);
     roboEyes.setIdleMode(OFF);
     roboEyes.setAutoblinker(OFF);
-    Serial.println("CurrentState: LongHappy");
+    Log.println("CurrentState: LongHappy");
   }
 
   void enterScaredState()
   {
     currentEyeState = Scared;
     roboEyes.setMood(TIRED);
-    roboEyes.setWidth(32, 32);
-    roboEyes.setHeight(36, 36);
-    roboEyes.setBorderradius(8, 8);
+    roboEyes.setWidth(Layout::eyeWidth(32), Layout::eyeWidth(32));
+    roboEyes.setHeight(Layout::eyeHeight(36), Layout::eyeHeight(36));
+    roboEyes.setBorderradius(Layout::eyeHeight(8), Layout::eyeHeight(8));
     roboEyes.setPosition(DEFAULT);
-    roboEyes.setSweat(ON);
+    setSweat(ON);
     roboEyes.setVFlicker(ON, 3);
     roboEyes.setHFlicker(ON, 3);
     roboEyes.setAutoblinker(OFF);
-    Serial.println("CurrentState: Scared");
+    Log.println("CurrentState: Scared");
   }
 
   void enterScareState()
   {
     currentEyeState = Scare;
     roboEyes.setMood(TIRED);
-    roboEyes.setWidth(32, 32);
-    roboEyes.setHeight(36, 36);
-    roboEyes.setBorderradius(8, 8);
+    roboEyes.setWidth(Layout::eyeWidth(32), Layout::eyeWidth(32));
+    roboEyes.setHeight(Layout::eyeHeight(36), Layout::eyeHeight(36));
+    roboEyes.setBorderradius(Layout::eyeHeight(8), Layout::eyeHeight(8));
     roboEyes.setPosition(DEFAULT);
-    roboEyes.setSweat(OFF);
+    setSweat(OFF);
     roboEyes.setVFlicker(ON, 3);
     roboEyes.setHFlicker(ON, 3);
     roboEyes.setAutoblinker(OFF);
-    Serial.println("CurrentState: Scare");
+    Log.println("CurrentState: Scare");
   }
 
   void enterCuriosityState()
   {
     currentEyeState = Curiosity;
     roboEyes.setMood(DEFAULT);
-    roboEyes.setWidth(32, 32);
-    roboEyes.setHeight(36, 36);
-    roboEyes.setBorderradius(8, 8);
+    roboEyes.setWidth(Layout::eyeWidth(32), Layout::eyeWidth(32));
+    roboEyes.setHeight(Layout::eyeHeight(36), Layout::eyeHeight(36));
+    roboEyes.setBorderradius(Layout::eyeHeight(8), Layout::eyeHeight(8));
     roboEyes.setPosition(DEFAULT);
     roboEyes.setAutoblinker(ON, 2, 2);
     roboEyes.setIdleMode(ON, 2, 2);
     roboEyes.setHFlicker(OFF);
-    roboEyes.setSweat(OFF);
+    setSweat(OFF);
     roboEyes.setCuriosity(ON);
-    Serial.println("CurrentState: Curiosity");
+    Log.println("CurrentState: Curiosity");
   }
 
   void enterSleepyState()
   {
     currentEyeState = Sleepy;
     roboEyes.setMood(TIRED);
-    roboEyes.setHeight(20, 20);
+    roboEyes.setHeight(Layout::eyeHeight(20), Layout::eyeHeight(20));
     roboEyes.setPosition(DEFAULT);
-    roboEyes.setSweat(OFF);
+    setSweat(OFF);
     roboEyes.setAutoblinker(ON, 2, 2);
     roboEyes.setIdleMode(OFF);
-    Serial.println("CurrentState: Sleepy");
+    Log.println("CurrentState: Sleepy");
   }
 
   void enterAsleepState()
@@ -161,23 +207,23 @@ private:
     currentEyeState = Asleep;
     roboEyes.setMood(DEFAULT);
     roboEyes.setPosition(SOUTH);
-    roboEyes.setHeight(3, 3);
+    roboEyes.setHeight(Layout::eyeHeight(3), Layout::eyeHeight(3));
     roboEyes.setAutoblinker(OFF);
     roboEyes.setIdleMode(OFF);
     roboEyes.setBorderradius(0, 0);
-    Serial.println("CurrentState: Asleep");
+    Log.println("CurrentState: Asleep");
   }
 
   void enterAngryState()
   {
     currentEyeState = Angry;
     roboEyes.setMood(ANGRY);
-    roboEyes.setWidth(32, 32);
-    roboEyes.setHeight(36, 36);
-    roboEyes.setBorderradius(8, 8);
+    roboEyes.setWidth(Layout::eyeWidth(32), Layout::eyeWidth(32));
+    roboEyes.setHeight(Layout::eyeHeight(36), Layout::eyeHeight(36));
+    roboEyes.setBorderradius(Layout::eyeHeight(8), Layout::eyeHeight(8));
     roboEyes.setPosition(DEFAULT);
     roboEyes.setHFlicker(ON, 2);
-    Serial.println("CurrentState: Angry");
+    Log.println("CurrentState: Angry");
   }
 
   void resetMovementHistory()
@@ -189,7 +235,7 @@ private:
     {
       movementHistory[i] = 0;
     }
-    Serial.println("Movement history reset");
+    Log.println("Movement history reset");
   }
 
   void addMovementToHistory(int movement)
@@ -208,25 +254,25 @@ private:
     movementCount++;
 
     // Print history untuk debugging
-    Serial.print("Movement history [");
-    Serial.print(movementCount);
-    Serial.print("/12]: ");
+    Log.print("Movement history [");
+    Log.print(movementCount);
+    Log.print("/12]: ");
     for (int i = 0; i < movementCount; i++)
     {
       if (movementHistory[i] == 1)
-        Serial.print("F");
+        Log.print("F");
       else if (movementHistory[i] == 2)
-        Serial.print("B");
+        Log.print("B");
       else if (movementHistory[i] == 3)
-        Serial.print("L");
+        Log.print("L");
       else if (movementHistory[i] == 4)
-        Serial.print("R");
-      Serial.print(" ");
+        Log.print("R");
+      Log.print(" ");
     }
-    Serial.print(" | L:");
-    Serial.print(leftCount);
-    Serial.print(" R:");
-    Serial.println(rightCount);
+    Log.print(" | L:");
+    Log.print(leftCount);
+    Log.print(" R:");
+    Log.println(rightCount);
   }
 
   bool canResetMovementHistory()
@@ -246,7 +292,7 @@ private:
     // Cek apakah perlu reset
     if (canResetMovementHistory())
     {
-      Serial.println(">>> Balanced! Resetting history <<<");
+      Log.println(">>> Balanced! Resetting history <<<");
       resetMovementHistory();
     }
 
@@ -260,12 +306,12 @@ private:
       if (leftCount < rightCount)
       {
         motorChoice = 3; // Left
-        Serial.println("Force LEFT to balance");
+        Log.println("Force LEFT to balance");
       }
       else if (rightCount < leftCount)
       {
         motorChoice = 4; // Right
-        Serial.println("Force RIGHT to balance");
+        Log.println("Force RIGHT to balance");
       }
       else
       {
@@ -283,19 +329,19 @@ private:
     switch (motorChoice)
     {
     case 1:
-      Serial.print("Motor: Forward");
+      Log.print("Motor: Forward");
       motor.forward();
       break;
     case 2:
-      Serial.print("Motor: Backward");
+      Log.print("Motor: Backward");
       motor.backward();
       break;
     case 3:
-      Serial.print("Motor: Left");
+      Log.print("Motor: Left");
       motor.left();
       break;
     case 4:
-      Serial.print("Motor: Right");
+      Log.print("Motor: Right");
       motor.right();
       break;
     }
@@ -308,11 +354,12 @@ private:
   }
 
 public:
-  RobotPet(Adafruit_SSD1306 &disp, SoundPlayer &buzzer, MotorManager &mtr, int width, int heigh, int delay)
+  RobotPet(EyeDisplay &disp, SoundPlayer &buzzer, MotorManager &mtr, int width, int heigh, int delay)
       : display(disp), roboEyes(disp), melody(buzzer), motor(mtr),
         screenWidth(width), screenHeight(heigh), refreshDelay(delay),
         currentEyeState(Default), lastActionTime(0), lastMotorActionTime(0),
-        randomMotorInterval(0), isRunning(false), movementCount(0),
+        randomMotorInterval(0), isRunning(false), governor(nullptr),
+        appliedLevel(GOVERNOR_FULL), sweatWanted(false), movementCount(0),
         leftCount(0), rightCount(0) {}
 
   void begin()
@@ -320,6 +367,22 @@ public:
     motor.begin();
     melody.play("G4 100 20 C5 100 20 E5 100 20 G5 100 20 C6 100 20 D6 100 20 E6 200 200");
     roboEyes.begin(screenWidth, screenHeight, refreshDelay);
+    // Animasi berbasis waktu, kecepatan tidak bergantung frame rate
+    roboEyes.setTweenMode(TWEEN_TIMED);
+    roboEyes.setAnalyticRenderer(ON);
+    roboEyes.setSpriteCache(EYE_SPRITE_SLOTS);
+    roboEyes.setFrameSkipping(ON);
+#if DUAL_PANEL == DUAL_PANEL_MIRROR
+    // Satu mata di tengah, panel kedua menerima salinannya: tiap panel
+    // satu mata yang sama dengan satu kali rasterisasi
+    roboEyes.setCyclops(ON);
+#endif
+    // Getaran vertikal lewat start line panel, tanpa menggambar ulang mata
+    roboEyes.setVerticalShiftHandler([this](int rows)
+                                     { return display.setVerticalOffset(rows); });
+    // Tepi mata lembut, tanpa efek jika grayscale tidak aktif
+    roboEyes.setSoftEdges([this](int x, int y, int h)
+                          { display.drawFastVLineGray(x, y, h, EYE_EDGE_LEVEL); });
     setDefaultState();
 
     resetMovementHistory();
@@ -328,17 +391,30 @@ public:
     randomMotorInterval = random(1600, 10000);
   }
 
-  void start()
+  // restored: buffer sudah berisi frame mata terakhir dari snapshot
+  void start(bool restored = false)
   {
     if (isRunning)
       return;
 
     isRunning = true;
+    // Layar lain sudah menggambar di buffer, frame pertama harus digambar ulang.
+    // Snapshot hanya berisi panel kiri, panel kanan split dikosongkan saat stop.
+    if (!restored || Layout::SPLIT_EYES)
+    {
+      roboEyes.invalidateFrame();
+    }
     lastActionTime = millis();
     lastMotorActionTime = millis();
     randomMotorInterval = random(1600, 10000);
 
-    Serial.println("RobotPet: Started");
+    Log.println("RobotPet: Started");
+  }
+
+  // Gambar ulang frame berikutnya walau mata diam, mis. saat overlay berubah
+  void redraw()
+  {
+    roboEyes.invalidateFrame();
   }
 
   void stop()
@@ -348,8 +424,31 @@ public:
 
     isRunning = false;
     motor.stop();
+    display.setVerticalOffset(0);
+#if DUAL_PANEL == DUAL_PANEL_SPLIT
+    display.releaseRight();
+#endif
+
+    Log.println("RobotPet: Stopped");
+  }
+
+  // Target frame rate diambil dari refreshDelay (fps)
+  void setGovernor(FrameGovernor *frameGovernor)
+  {
+    governor = frameGovernor;
+    if (governor)
+    {
+      // Peak dan marquee tidak ada di layar mata
+      static const GovernorLevel EYE_STEPS[] = {GOVERNOR_DROP_SWEAT, GOVERNOR_HALF_RATE};
+      governor->setSteps(EYE_STEPS, 2);
+      governor->setFrameInterval(1000 / refreshDelay);
+      appliedLevel = -1;
+    }
+  }
 
-    Serial.println("RobotPet: Stopped");
+  int getGovernorLevel()
+  {
+    return governor ? governor->getLevel() : GOVERNOR_FULL;
   }
 
   bool getRunningState()
@@ -357,6 +456,33 @@ public:
     return isRunning;
   }
 
+  // Membandingkan renderer analitik dengan renderer primitive pada frame acak
+  int verifyEyeRenderer(int samples)
+  {
+    display.waitForFlush();
+    return roboEyes.verifyAnalyticRenderer(samples);
+  }
+
+  unsigned long getFramesDrawn()
+  {
+    return roboEyes.getFramesDrawn();
+  }
+
+  unsigned long getFramesSkipped()
+  {
+    return roboEyes.getFramesSkipped();
+  }
+
+  unsigned long getEyeCacheHits()
+  {
+    return roboEyes.getSpriteCacheHits();
+  }
+
+  unsigned long getEyeCacheMisses()
+  {
+    return roboEyes.getSpriteCacheMisses();
+  }
+
   void update()
   {
     if (!isRunning)
@@ -467,7 +593,17 @@ public:
       break;
     }
 
+    if (!governor)
+    {
+      roboEyes.update();
+      return;
+    }
+
+    applyGovernorLevel();
+    unsigned long drawn = roboEyes.getFramesDrawn();
+    governor->beginFrame();
     roboEyes.update();
+    governor->endFrame(roboEyes.getFramesDrawn() != drawn);
   }
 
   void shortClick(int clickCount)
@@ -475,8 +611,8 @@ public:
     if (!isRunning)
       return;
 
-    Serial.print("Click: ");
-    Serial.println(clickCount);
+    Log.print("Click: ");
+    Log.println(clickCount);
 
     if ((currentEyeState == Asleep || currentEyeState == Sleepy))
     {
@@ -513,7 +649,7 @@ public:
     if (!isRunning)
       return;
 
-    Serial.println("LONG PRESS!");
+    Log.println("LONG PRESS!");
     if (currentEyeState == Default || currentEyeState == Curiosity)
     {
       enterLongHappyState();
@@ -526,7 +662,7 @@ public:
     if (!isRunning)
       return;
 
-    Serial.println("LONG PRESS RELEASE!");
+    Log.println("LONG PRESS RELEASE!");
     currentEyeState = Happy;
   }
 };
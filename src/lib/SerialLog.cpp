@@ -0,0 +1,40 @@
+#include "SerialLog.h"
+
+SerialLog Log;
+
+SerialLog::SerialLog()
+    : muted(false),
+      dropped(0)
+{
+}
+
+size_t SerialLog::write(uint8_t c)
+{
+  return write(&c, 1);
+}
+
+size_t SerialLog::write(const uint8_t *data, size_t length)
+{
+  // Tetap melaporkan semua byte tertulis agar pemanggil tidak menganggapnya error
+  if (muted)
+  {
+    dropped += length;
+    return length;
+  }
+  return Serial.write(data, length);
+}
+
+void SerialLog::setMuted(bool mute)
+{
+  muted = mute;
+}
+
+bool SerialLog::isMuted()
+{
+  return muted;
+}
+
+unsigned long SerialLog::getDropped()
+{
+  return dropped;
+}
@@ -0,0 +1,29 @@
+#ifndef SERIAL_LOG_H
+#define SERIAL_LOG_H
+
+#include <Arduino.h>
+
+// Semua log teks lewat sini, bukan langsung ke Serial. Selama stream
+// mirror USB memakai Serial, log dibuang agar tidak menyisip di tengah
+// paket frame.
+class SerialLog : public Print
+{
+private:
+  volatile bool muted;
+  volatile unsigned long dropped; // byte log yang dibuang selama mute
+
+public:
+  SerialLog();
+
+  using Print::write;
+  size_t write(uint8_t c) override;
+  size_t write(const uint8_t *data, size_t length) override;
+
+  void setMuted(bool mute);
+  bool isMuted();
+  unsigned long getDropped();
+};
+
+extern SerialLog Log;
+
+#endif
@@ -1,5 +1,6 @@
 #pragma once
 #include <Arduino.h>
+#include "SerialLog.h"
 
 class SoundPlayer
 {
@@ -11,7 +12,7 @@ public:
 
   void play(const char *sequence)
   {
-    Serial.println("Melody Play");
+    Log.println("Melody Play");
     const char *p = sequence;
 
     while (*p)
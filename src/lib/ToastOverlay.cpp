@@ -0,0 +1,81 @@
+#include "ToastOverlay.h"
+#include "SerialLog.h"
+
+ToastOverlay::ToastOverlay(DisplayManager &disp)
+    : display(disp),
+      marquee(disp),
+      shownAt(0),
+      duration(DEFAULT_DURATION),
+      active(false),
+      changed(false)
+{
+}
+
+void ToastOverlay::show(const char *app, const char *message, unsigned long showFor)
+{
+  text = String(app);
+  if (message && message[0])
+  {
+    text += ": ";
+    text += message;
+  }
+
+  marquee.setText(text);
+  shownAt = millis();
+  duration = showFor;
+  active = true;
+  changed = true;
+
+  Log.println("[Toast] " + text);
+}
+
+void ToastOverlay::dismiss()
+{
+  if (!active)
+    return;
+
+  active = false;
+  changed = true;
+  marquee.clear();
+}
+
+bool ToastOverlay::isActive()
+{
+  return active;
+}
+
+bool ToastOverlay::update()
+{
+  if (active && millis() - shownAt >= duration)
+  {
+    dismiss();
+  }
+
+  if (active && marquee.getTextWidth() > TEXT_WIDTH && marquee.update())
+  {
+    changed = true;
+  }
+
+  bool result = changed;
+  changed = false;
+  return result;
+}
+
+bool ToastOverlay::draw()
+{
+  if (!active)
+    return false;
+
+  display.fillRect(0, Layout::TOAST_Y, Layout::WIDTH, Layout::TOAST_HEIGHT, SSD1306_BLACK);
+  display.drawFastHLine(0, Layout::TOAST_Y, Layout::WIDTH, SSD1306_WHITE);
+
+  if (marquee.getTextWidth() > TEXT_WIDTH)
+  {
+    marquee.draw(Layout::TOAST_TEXT_X, Layout::TOAST_TEXT_Y, TEXT_WIDTH);
+  }
+  else
+  {
+    marquee.draw(Layout::TOAST_TEXT_X, Layout::TOAST_TEXT_Y, marquee.getTextWidth());
+  }
+  return true;
+}
@@ -0,0 +1,46 @@
+#ifndef TOAST_OVERLAY_H
+#define TOAST_OVERLAY_H
+
+#include <Arduino.h>
+#include "DisplayManager.h"
+#include "MarqueeStrip.h"
+#include "PanelLayout.h"
+
+// Notifikasi pendek sebagai strip di atas layar yang sedang aktif (layer
+// mata), tanpa pindah state. Digambar oleh overlay DisplayManager tepat
+// sebelum frame dikirim, jadi hanya region toast dan layer di bawahnya
+// yang berubah.
+class ToastOverlay
+{
+private:
+  DisplayManager &display;
+
+  String text;
+  MarqueeStrip marquee;
+  unsigned long shownAt;
+  unsigned long duration;
+  bool active;
+  bool changed;
+
+  static const int TEXT_WIDTH = Layout::WIDTH - Layout::TOAST_TEXT_X * 2;
+
+public:
+  static const unsigned long DEFAULT_DURATION = 4000;
+  // Notifikasi dengan teks lebih dari ini tetap memakai layar Notification
+  static const int MAX_LINES = 1;
+
+  ToastOverlay(DisplayManager &disp);
+
+  void show(const char *app, const char *message, unsigned long duration = DEFAULT_DURATION);
+  void dismiss();
+  bool isActive();
+
+  // Dipanggil dari loop; true jika toast muncul, bergeser atau hilang dan
+  // layer di bawahnya perlu menggambar frame baru
+  bool update();
+
+  // Callback overlay, menggambar strip ke buffer display; false jika tidak aktif
+  bool draw();
+};
+
+#endif
@@ -1,7 +1,9 @@
 #include <Arduino.h>
 #include <Wire.h>
 #include <Adafruit_GFX.h>
-#include <Adafruit_SSD1306.h>
+#include "lib/DisplayManager.h"
+#include "lib/DualDisplay.h"
+#include "lib/PanelLayout.h"
 #include "lib/SoundPlayer.h"
 #include "lib/RobotPet.h"
 #include "lib/MotorManager.h"
@@ -11,12 +13,19 @@
 #include "lib/NotificationManager.h"
 #include "lib/MenuManager.h"
 #include "lib/ConfigManager.h"
+#include "lib/RenderBenchmark.h"
+#include "lib/ToastOverlay.h"
+#include "lib/FrameMirror.h"
+#include "lib/FrameGovernor.h"
+#include "lib/MediaFrame.h"
+#include "lib/MessageParser.h"
+#include "lib/SerialLog.h"
 #include <ArduinoJson.h>
 
-#define SCREEN_WIDTH 128
-#define SCREEN_HEIGHT 64
+#define SCREEN_WIDTH PANEL_WIDTH
+#define SCREEN_HEIGHT PANEL_HEIGHT
 #define OLED_RESET -1
-#define SCREEN_ADDRESS 0x3C
+#define SCREEN_ADDRESS PANEL_ADDRESS
 
 #define I2C_SDA_PIN 6
 #define I2C_SCL_PIN 7
@@ -29,16 +38,34 @@
 #define MOTOR_IN3 2
 #define MOTOR_IN4 3
 
-Adafruit_SSD1306 display(SCREEN_WIDTH, SCREEN_HEIGHT, &Wire, OLED_RESET);
+#if PANEL_SPI
+DisplayManager display(SCREEN_WIDTH, SCREEN_HEIGHT, &SPI, PANEL_SPI_DC, PANEL_SPI_RST, PANEL_SPI_CS, PANEL_SPI_CLOCK);
+#else
+DisplayManager display(SCREEN_WIDTH, SCREEN_HEIGHT, &Wire, OLED_RESET);
+#endif
+#if DUAL_PANEL
+DisplayManager display2(SCREEN_WIDTH, SCREEN_HEIGHT, &Wire, OLED_RESET);
+#endif
+#if DUAL_PANEL == DUAL_PANEL_SPLIT
+DualDisplay eyeDisplay(display, display2);
+#else
+DisplayManager &eyeDisplay = display;
+#endif
 MotorManager motor(MOTOR_IN1, MOTOR_IN2, MOTOR_IN3, MOTOR_IN4);
 SoundPlayer melody(BUZZER_PIN);
 ButtonManager button(BUTTON_PIN);
 BLEManager ble;
-RobotPet robotPet(display, melody, motor, SCREEN_WIDTH, SCREEN_HEIGHT, 100);
+RobotPet robotPet(eyeDisplay, melody, motor, Layout::EYE_CANVAS_WIDTH, SCREEN_HEIGHT, 100);
 MediaVisualizer visualizer(display, FPS_30);
 NotificationManager notification(display, 15000);
+ToastOverlay toast(display);
 MenuManager menu(display);
 ConfigManager configManager;
+RenderBenchmark benchmark(display);
+FrameMirror frameMirror(display, ble);
+FrameGovernor eyesGovernor(display, "Eyes");
+FrameGovernor mediaGovernor(display, "Media");
+MessageParser messageParser;
 
 enum CurrentState
 {
@@ -54,28 +81,47 @@ unsigned long lastMediaActive = 0;
 static const unsigned long MEDIA_TIMEOUT = 5000;
 static const float AUDIO_THRESHOLD = 0.01f;
 
+// Sequence frame amplitudo biner terakhir; direset saat disconnect karena
+// ponsel mulai lagi dari nomor kecil setelah reconnect
+bool hasMediaSequence = false;
+uint16_t lastMediaSequence = 0;
+static const unsigned long FADE_OUT_TIME = 120;
+static const unsigned long FADE_IN_TIME = 200;
+
 bool bluetoothEnabled = false;
 bool wifiEnabled = false;
+bool grayscaleEnabled = false;
+bool mirrorUsbEnabled = false;
+bool mirrorBleEnabled = false;
 String firmwareVersion = "v1.0.0";
 
-void handleBLEMessage(String message);
+void handleBLEMessage(char *message, size_t length);
+void handleBLEBinary(const uint8_t *data, size_t length);
 void scanI2C();
 void switchState(CurrentState newState);
 void updateCurrentState();
 void setupMenu();
+void calibrateDisplayBus();
+void beginSecondPanel();
 
 void setup()
 {
   Serial.begin(115200);
 
+#if PANEL_SPI
+  // Pin SPI bawaan ESP32-C3 bertabrakan dengan pin I2C, bus I2C tidak dipakai
+  SPI.begin(PANEL_SPI_SCK, -1, PANEL_SPI_MOSI, PANEL_SPI_CS);
+#else
   Wire.begin(I2C_SDA_PIN, I2C_SCL_PIN);
   Wire.setClock(100000);
   scanI2C();
+#endif
 
   SettingConfig settingConfig = configManager.loadSettingsConfig();
 
   bluetoothEnabled = settingConfig.bluetooth;
   wifiEnabled = settingConfig.wifi;
+  grayscaleEnabled = settingConfig.grayscale;
 
   button.begin();
   button.addClickCallback([](int count)
@@ -113,27 +159,50 @@ void setup()
 
   if (!display.begin(SSD1306_SWITCHCAPVCC, SCREEN_ADDRESS))
   {
-    Serial.println("[Display] Failed!");
+    Log.println("[Display] Failed!");
     while (1)
       ;
   }
 
+  // SPI tidak punya ACK, kalibrasi hanya mengukur waktu frame; di SPI
+  // kalibrasi cukup lewat menu "Calibrate Bus"
+  if (!PANEL_SPI && settingConfig.i2cClock > 0)
+  {
+    display.setBusClock(settingConfig.i2cClock);
+  }
+  else if (!PANEL_SPI)
+  {
+    calibrateDisplayBus();
+  }
+  display.setAsyncFlush(true);
+  beginSecondPanel();
+  if (grayscaleEnabled && !display.setGrayscale(true))
+  {
+    grayscaleEnabled = false;
+  }
+  display.setOverlay([]()
+                     { return toast.draw(); });
+
+  robotPet.setGovernor(&eyesGovernor);
+  visualizer.setGovernor(&mediaGovernor);
   robotPet.begin();
   visualizer.begin();
   notification.begin();
   menu.begin();
   setupMenu();
 
-  ble.setOnMessageCallback([](String message)
-                           { handleBLEMessage(message); });
+  messageParser.begin();
+  ble.setOnMessageCallback(handleBLEMessage);
+  ble.setOnBinaryCallback(handleBLEBinary);
   ble.setOnConnectCallback([]()
                            { 
-    Serial.println("[BLE] Connected");
+    Log.println("[BLE] Connected");
  
       melody.play("G4 100 20 C5 100 20 E5 100 20 G5 100 20 C6 100 20 D6 100 20 E6 200 200"); });
   ble.setOnDisconnectCallback([]()
                               {
-    Serial.println("[BLE] Disconnected");
+    Log.println("[BLE] Disconnected");
+    hasMediaSequence = false;
 
       melody.play("E6 100 20 D6 100 20 C6 120 40 G5 150 100");
     
@@ -167,8 +236,8 @@ void setupMenu()
   auto bluetoothMenu = menu.createSubmenu();
   menu.addToggleToSubmenu(bluetoothMenu, "BT Enable", &bluetoothEnabled, [](bool state)
                           {
-    Serial.print("[BLE] Turned ");
-    Serial.println(state ? "ON" : "OFF");
+    Log.print("[BLE] Turned ");
+    Log.println(state ? "ON" : "OFF");
     if (state) {
       ble.turnOn();
       melody.play("C5 100 20 E5 100 20 G5 150 20");
@@ -181,7 +250,7 @@ void setupMenu()
 
   menu.addActionToSubmenu(bluetoothMenu, "Reconnect", []()
                           {
-    Serial.println("[BLE] Reconnecting...");
+    Log.println("[BLE] Reconnecting...");
     ble.turnOff();
     delay(500);
     ble.turnOn();
@@ -190,11 +259,33 @@ void setupMenu()
   menu.addInfoToSubmenu(bluetoothMenu, "Status", []()
                         { return bluetoothEnabled ? "Active" : "Off"; });
 
+  // Isi tertinggi antrean pesan BLE dan pesan yang terbuang karena penuh
+  menu.addInfoToSubmenu(bluetoothMenu, "Queue", []()
+                        { return String(ble.getQueueHighWater()) + "/" + String(ble.getQueueCapacity()) +
+                                 " drop " + String(ble.getQueueOverflows()); });
+
+  // Pesan media/amplitudo basi yang dibuang per pesan yang diproses
+  menu.addInfoToSubmenu(bluetoothMenu, "Coalesced", []()
+                        { return "M" + String(ble.getCoalescedCount(MESSAGE_MEDIA)) + "/" + String(ble.getProcessedCount(MESSAGE_MEDIA)) +
+                                 " A" + String(ble.getCoalescedCount(MESSAGE_AMPLITUDE)) + "/" + String(ble.getProcessedCount(MESSAGE_AMPLITUDE)); });
+
+  // Ukuran dan waktu parse pesan JSON terakhir, serta alokasi heap
+  // (seharusnya 0 selama arena cukup)
+  menu.addInfoToSubmenu(bluetoothMenu, "JSON", []()
+                        {
+    ParseStats stats = messageParser.getStats();
+    return String(stats.lastBytes) + "B " + String(stats.lastParseTime) + "us"; });
+
+  menu.addInfoToSubmenu(bluetoothMenu, "JSON Heap", []()
+                        {
+    ParseStats stats = messageParser.getStats();
+    return String(stats.heapAllocations) + " arena " + String(stats.arenaPeak); });
+
   auto wifiMenu = menu.createSubmenu();
   menu.addToggleToSubmenu(wifiMenu, "WiFi Enable", &wifiEnabled, [](bool state)
                           {
-    Serial.print("[WiFi] Turned ");
-    Serial.println(state ? "ON" : "OFF");
+    Log.print("[WiFi] Turned ");
+    Log.println(state ? "ON" : "OFF");
    
       if (state) {
         melody.play("C5 100 20 E5 100 20");
@@ -204,7 +295,7 @@ void setupMenu()
 
   menu.addActionToSubmenu(wifiMenu, "Scan Networks", []()
                           {
-    Serial.println("[WiFi] Scanning...");
+    Log.println("[WiFi] Scanning...");
      melody.play("C5 50 10 E5 50 10 G5 50 10"); });
 
   menu.addInfoToSubmenu(wifiMenu, "Status", []()
@@ -215,9 +306,96 @@ void setupMenu()
 
   menu.addSubmenu("Connectivity", connectivityMenu);
 
+  auto displayMenu = menu.createSubmenu();
+  menu.addActionToSubmenu(displayMenu, "Calibrate Bus", []()
+                          {
+    calibrateDisplayBus();
+    melody.play("C5 100 20 G5 100 20"); });
+
+  menu.addInfoToSubmenu(displayMenu, "Bus Clock", []()
+                        { return String(display.getBusClock() / 1000) + "kHz"; });
+
+  menu.addInfoToSubmenu(displayMenu, "Full Flush", []()
+                        {
+    BusCalibration calibration = display.getBusCalibration();
+    if (calibration.frameTime == 0)
+      return String("-");
+    return String(calibration.frameTime / 1000.0f, 1) + "ms"; });
+
+  menu.addToggleToSubmenu(displayMenu, "Grayscale", &grayscaleEnabled, [](bool state)
+                          {
+    if (!display.setGrayscale(state))
+    {
+      grayscaleEnabled = false;
+      melody.play("G4 200 20 C4 300 20");
+      return;
+    }
+    configManager.saveSettingsConfig("grayscale", state); });
+
+  menu.addInfoToSubmenu(displayMenu, "Subframes", []()
+                        {
+    if (!display.isGrayscale())
+      return String("-");
+    return String(display.getFlushStats().subframeRate) + "Hz"; });
+
+  menu.addActionToSubmenu(displayMenu, "Raster Bench", []()
+                          { benchmark.runRasterBenchmark(); });
+
+  menu.addActionToSubmenu(displayMenu, "Eye Geo Bench", []()
+                          { benchmark.runEyeGeometryBenchmark(); });
+
+  menu.addActionToSubmenu(displayMenu, "Frame Bench", []()
+                          { benchmark.runFrameTimeBenchmark(); });
+
+  menu.addActionToSubmenu(displayMenu, "Eye Render Check", []()
+                          {
+    if (robotPet.verifyEyeRenderer(500) == 0)
+      melody.play("C5 100 20 G5 100 20");
+    else
+      melody.play("G4 200 20 C4 300 20"); });
+
+  menu.addInfoToSubmenu(displayMenu, "Eye Skipped", []()
+                        {
+    unsigned long skipped = robotPet.getFramesSkipped();
+    unsigned long total = skipped + robotPet.getFramesDrawn();
+    if (total == 0)
+      return String("-");
+    return String(skipped * 100 / total) + "% of " + String(total); });
+
+  menu.addInfoToSubmenu(displayMenu, "Eye Cache", []()
+                        {
+    unsigned long hits = robotPet.getEyeCacheHits();
+    unsigned long total = hits + robotPet.getEyeCacheMisses();
+    if (total == 0)
+      return String("-");
+    return String(hits * 100 / total) + "% of " + String(total); });
+
+  // Level degradasi efek per layar (0 = semua efek aktif)
+  menu.addInfoToSubmenu(displayMenu, "Governor", []()
+                        { return "E" + String(robotPet.getGovernorLevel()) + " M" + String(visualizer.getGovernorLevel()); });
+
+  // Stream layar ke tools/mirror_viewer, satu transport dalam satu waktu
+  menu.addToggleToSubmenu(displayMenu, "Mirror USB", &mirrorUsbEnabled, [](bool state)
+                          {
+    mirrorBleEnabled = false;
+    frameMirror.setTransport(state ? MIRROR_SERIAL : MIRROR_OFF); });
+
+  menu.addToggleToSubmenu(displayMenu, "Mirror BLE", &mirrorBleEnabled, [](bool state)
+                          {
+    mirrorUsbEnabled = false;
+    frameMirror.setTransport(state ? MIRROR_BLE : MIRROR_OFF); });
+
+  menu.addInfoToSubmenu(displayMenu, "Mirror Rate", []()
+                        {
+    if (frameMirror.getTransport() == MIRROR_OFF)
+      return String("-");
+    return String(frameMirror.getFrameRate()) + "fps " + String(frameMirror.getByteRate() / 1024.0f, 1) + "k"; });
+
+  menu.addSubmenu("Display", displayMenu);
+
   menu.addItem("Exit", ACTION, []()
                {
-    Serial.println("[Menu] Exiting...");
+    Log.println("[Menu] Exiting...");
     melody.play("G5 100 20 E5 100 20 C5 150 20");
     menu.hide();
     switchState(Animation); });
@@ -226,7 +404,20 @@ void setupMenu()
 void loop()
 {
   button.update();
+  ble.processMessages();
   updateCurrentState();
+  display.update();
+  frameMirror.update();
+}
+
+// Slot snapshot framebuffer untuk layar utama, -1 untuk layar sementara
+int snapshotSlot(CurrentState state)
+{
+  if (state == Animation)
+    return 0;
+  if (state == Media)
+    return 1;
+  return -1;
 }
 
 void switchState(CurrentState newState)
@@ -234,13 +425,30 @@ void switchState(CurrentState newState)
   if (currentState == newState)
     return;
 
-  if (newState != Notification && newState != Menu)
+  bool temporary = (newState == Notification || newState == Menu);
+  bool returning = (currentState == Notification || currentState == Menu);
+
+  if (!temporary)
   {
     previousState = currentState;
   }
 
+  // Panel diredupkan lalu dimatikan oleh display.update() tanpa memblokir
+  // loop; layar baru muncul saat frame pertamanya terkirim
+  display.fadeOut(FADE_OUT_TIME);
+
+  // Layar utama yang ditinggal sementara disimpan; hanya snapshot layar
+  // terakhir yang berlaku
+  int leavingSlot = snapshotSlot(currentState);
+  if (temporary && leavingSlot >= 0)
+  {
+    display.discardSnapshots();
+    display.saveSnapshot(leavingSlot);
+  }
+
   if (currentState == Animation)
   {
+    toast.dismiss();
     robotPet.stop();
   }
   else if (currentState == Media)
@@ -252,29 +460,42 @@ void switchState(CurrentState newState)
     menu.hide();
   }
 
-  Serial.print("[State] ");
-  Serial.print(currentState == Animation ? "Animation" : currentState == Media ? "Media"
+  Log.print("[State] ");
+  Log.print(currentState == Animation ? "Animation" : currentState == Media ? "Media"
                                                      : currentState == Menu    ? "Menu"
                                                                                : "Notification");
-  Serial.print(" -> ");
-  Serial.println(newState == Animation ? "Animation" : newState == Media ? "Media"
+  Log.print(" -> ");
+  Log.println(newState == Animation ? "Animation" : newState == Media ? "Media"
                                                    : newState == Menu    ? "Menu"
                                                                          : "Notification");
 
   currentState = newState;
 
+  // Kembali dari layar sementara: frame pertama cukup salin snapshot + flush
+  bool restored = returning && display.restoreSnapshot(snapshotSlot(currentState));
+
   if (currentState == Animation)
   {
-    robotPet.start();
+    robotPet.start(restored);
   }
   else if (currentState == Media)
   {
+    // Snapshot hanya frame pertama; visualizer lanjut menggambar walau
+    // data baru belum datang
+    visualizer.start();
     lastMediaActive = millis();
   }
   else if (currentState == Menu)
   {
     menu.show();
   }
+
+  display.fadeIn(FADE_IN_TIME);
+  if (restored)
+  {
+    // Panel langsung menyala bersama frame snapshot
+    display.display();
+  }
 }
 
 void updateCurrentState()
@@ -286,6 +507,11 @@ void updateCurrentState()
   switch (currentState)
   {
   case Animation:
+    // Toast berubah: frame mata digambar ulang agar overlay ikut terkirim
+    if (toast.update())
+    {
+      robotPet.redraw();
+    }
     robotPet.update();
     break;
 
@@ -294,7 +520,7 @@ void updateCurrentState()
 
     if (elapsedMediaActive > MEDIA_TIMEOUT)
     {
-      Serial.println("[Media] Timeout - no audio detected");
+      Log.println("[Media] Timeout - no audio detected");
       switchState(Animation);
     }
     break;
@@ -304,7 +530,7 @@ void updateCurrentState()
 
     if (notification.isExpired())
     {
-      Serial.println("[Notification] Expired");
+      Log.println("[Notification] Expired");
       switchState(previousState);
     }
     break;
@@ -315,39 +541,76 @@ void updateCurrentState()
   }
 }
 
+void calibrateDisplayBus()
+{
+  BusCalibration calibration = display.calibrateBusSpeed();
+  if (calibration.clock > 0 && !display.isSpi())
+  {
+    configManager.saveSettingsConfig("i2c_clock", calibration.clock);
+  }
+#if DUAL_PANEL
+  display2.setBusClock(display.getBusClock());
+#endif
+}
+
+void beginSecondPanel()
+{
+#if DUAL_PANEL
+  // Kedua flush task bergantian memakai bus, render tetap berjalan paralel
+  display2.shareBus(display);
+  if (!display2.begin(SSD1306_SWITCHCAPVCC, PANEL_ADDRESS_2))
+  {
+    Log.println("[Display] Second panel failed!");
+    return;
+  }
+  display2.setBusClock(display.getBusClock());
+  display2.setAsyncFlush(true);
+  display2.clearDisplay();
+  display2.display();
+#if DUAL_PANEL == DUAL_PANEL_MIRROR
+  display.setMirror(&display2);
+#else
+  display.setFadePartner(&display2);
+#endif
+#endif
+}
+
 void scanI2C()
 {
-  Serial.println("[I2C] Scanning...");
+  Log.println("[I2C] Scanning...");
   for (byte addr = 1; addr < 127; addr++)
   {
     Wire.beginTransmission(addr);
     if (Wire.endTransmission() == 0)
     {
-      Serial.print("[I2C] Found: 0x");
-      Serial.println(addr, HEX);
+      Log.print("[I2C] Found: 0x");
+      Log.println(addr, HEX);
     }
   }
 }
 
-void handleBLEMessage(String message)
+void handleBLEMessage(char *message, size_t length)
 {
-  if (message.startsWith("\"") && message.endsWith("\""))
-  {
-    message = message.substring(1, message.length() - 1);
-  }
-  message.replace("\\\"", "\"");
-
-  JsonDocument doc;
-  if (deserializeJson(doc, message))
-  {
-    Serial.println("[JSON] Parse error");
+  // Dokumen milik messageParser, dipakai ulang untuk tiap pesan
+  JsonDocument *parsed = messageParser.parse(message, length);
+  if (!parsed)
     return;
-  }
+  JsonDocument &doc = *parsed;
 
   const char *type = doc["type"] | "";
 
   if (strcmp(type, "notification") == 0)
   {
+    // Notifikasi pendek tampil sebagai toast di atas mata, tanpa
+    // menghentikan animasi RobotPet
+    JsonArray texts = doc["texts"].as<JsonArray>();
+    if (currentState == Animation && texts.size() <= ToastOverlay::MAX_LINES)
+    {
+      toast.show(doc["app"] | "Unknown", texts.size() > 0 ? (texts[0] | "") : "");
+      melody.play("C6 80 20 G6 120 60");
+      return;
+    }
+
     if (currentState != Notification && currentState != Menu)
     {
       previousState = currentState;
@@ -375,6 +638,14 @@ void handleBLEMessage(String message)
       return;
     }
 
+    // Frame amplitudo biner yang lebih baru menyusul di batch ini; dia yang
+    // menentukan pindah layar, pesan ini cukup memperbarui judul/artis
+    if (ble.isAmplitudeSuperseded())
+    {
+      visualizer.handleMediaData(doc, false);
+      return;
+    }
+
     if (doc["audio_amplitude"].is<JsonObject>())
     {
       float amplitude = doc["audio_amplitude"]["amplitude"] | 0.0f;
@@ -393,4 +664,40 @@ void handleBLEMessage(String message)
 
     return;
   }
-}
\ No newline at end of file
+}
+
+// Frame amplitudo biner: jalur yang sama dengan pesan JSON "media" yang
+// hanya berisi audio_amplitude, tanpa parsing dan alokasi heap
+void handleBLEBinary(const uint8_t *data, size_t length)
+{
+  MediaFrame::Amplitude frame;
+  if (!MediaFrame::decodeAmplitude(data, length, frame))
+    return;
+
+  if (hasMediaSequence && !MediaFrame::isNewer(frame.sequence, lastMediaSequence))
+    return;
+  hasMediaSequence = true;
+  lastMediaSequence = frame.sequence;
+
+  if (currentState == Notification || currentState == Menu)
+  {
+    if (currentState != Menu)
+    {
+      previousState = Media;
+    }
+    return;
+  }
+
+  if (frame.amplitude > AUDIO_THRESHOLD)
+  {
+    if (currentState != Media)
+    {
+      switchState(Media);
+    }
+
+    visualizer.setAmplitude(frame.amplitude);
+    visualizer.setPeak(frame.peak);
+    visualizer.setRms(frame.rms);
+    lastMediaActive = millis();
+  }
+}
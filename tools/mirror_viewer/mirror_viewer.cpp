@@ -0,0 +1,246 @@
+// Decoder stream FrameMirror (src/lib/FrameMirror.h) ke file PBM per frame.
+//
+// Build : g++ -std=c++17 -O2 -o mirror_viewer mirror_viewer.cpp
+// USB   : stty -F /dev/ttyACM0 raw 115200 && ./mirror_viewer /dev/ttyACM0 frames
+// BLE   : simpan notify characteristic mirror ke file, lalu
+//         ./mirror_viewer dump.bin frames
+//
+// Device menahan log Serial selama stream USB aktif. Byte lain di stream
+// (mis. log sebelum stream dimulai) dilewati: paket dicari lewat byte sync
+// dan checksum. Setelah paket rusak atau nomor urut melompat, frame
+// berikutnya baru ditulis setelah keyframe (dikirim device tiap 2 detik).
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+
+namespace
+{
+  const int HEADER_SIZE = 11;
+  const int MAX_PAGES = 16;
+
+  struct Stats
+  {
+    unsigned long packets = 0;
+    unsigned long keyframes = 0;
+    unsigned long badPackets = 0;
+    unsigned long gaps = 0;
+    unsigned long payloadBytes = 0;
+    unsigned long written = 0;
+  };
+
+  class Decoder
+  {
+  public:
+    Decoder(const std::string &outDir) : outDir(outDir) {}
+
+    void feed(const uint8_t *data, size_t length)
+    {
+      pending.insert(pending.end(), data, data + length);
+
+      size_t pos = 0;
+      while (pending.size() - pos >= HEADER_SIZE + 1)
+      {
+        if (pending[pos] != 'E' || pending[pos + 1] != 'M')
+        {
+          pos++;
+          continue;
+        }
+
+        const uint8_t *h = pending.data() + pos;
+        size_t payload = h[9] | (h[10] << 8);
+        size_t total = HEADER_SIZE + payload + 1;
+        if (!plausible(h, payload))
+        {
+          pos++;
+          continue;
+        }
+        if (pending.size() - pos < total)
+          break;
+
+        if (!decode(h, payload))
+        {
+          stats.badPackets++;
+          synced = false;
+          pos++;
+          continue;
+        }
+        pos += total;
+      }
+      pending.erase(pending.begin(), pending.begin() + pos);
+    }
+
+    const Stats &getStats() const { return stats; }
+
+  private:
+    std::string outDir;
+    std::vector<uint8_t> pending;
+    std::vector<uint8_t> frame;
+    int width = 0;
+    int height = 0;
+    bool synced = false;
+    int lastSequence = -1;
+    Stats stats;
+
+    static bool plausible(const uint8_t *h, size_t payload)
+    {
+      int w = h[4];
+      int ht = h[5];
+      int pages = (ht + 7) / 8;
+      size_t worst = (size_t)pages * (w + (w + 127) / 128);
+      return (h[2] & ~1) == 0 && w > 0 && ht > 0 && pages <= MAX_PAGES && payload <= worst;
+    }
+
+    bool decode(const uint8_t *h, size_t payload)
+    {
+      uint8_t checksum = 0;
+      for (size_t i = 2; i < HEADER_SIZE + payload; i++)
+        checksum += h[i];
+      if (checksum != h[HEADER_SIZE + payload])
+        return false;
+
+      bool keyframe = h[2] & 1;
+      int sequence = h[3];
+      int w = h[4];
+      int ht = h[5];
+      int startLine = h[6];
+      uint16_t pageMask = h[7] | (h[8] << 8);
+      int pages = (ht + 7) / 8;
+
+      if (w != width || ht != height)
+      {
+        width = w;
+        height = ht;
+        frame.assign(width * pages, 0);
+        synced = false;
+      }
+
+      if (lastSequence >= 0 && sequence != ((lastSequence + 1) & 0xFF))
+      {
+        stats.gaps++;
+        synced = false;
+      }
+      lastSequence = sequence;
+
+      if (keyframe)
+      {
+        std::fill(frame.begin(), frame.end(), 0);
+        synced = true;
+        stats.keyframes++;
+      }
+
+      const uint8_t *in = h + HEADER_SIZE;
+      const uint8_t *end = in + payload;
+      for (int page = 0; page < pages; page++)
+      {
+        if (!(pageMask & (1 << page)))
+          continue;
+        if (!unpackPage(in, end, frame.data() + page * width))
+          return false;
+      }
+
+      stats.packets++;
+      stats.payloadBytes += payload;
+      if (synced)
+        writeFrame(startLine);
+      return true;
+    }
+
+    // PackBits, delta di-XOR ke frame
+    bool unpackPage(const uint8_t *&in, const uint8_t *end, uint8_t *row)
+    {
+      int col = 0;
+      while (col < width)
+      {
+        if (in >= end)
+          return false;
+        uint8_t control = *in++;
+        if (control < 128)
+        {
+          int count = control + 1;
+          if (col + count > width || in + count > end)
+            return false;
+          for (int i = 0; i < count; i++)
+            row[col++] ^= *in++;
+        }
+        else if (control > 128)
+        {
+          int count = 257 - control;
+          if (col + count > width || in >= end)
+            return false;
+          uint8_t value = *in++;
+          for (int i = 0; i < count; i++)
+            row[col++] ^= value;
+        }
+      }
+      return true;
+    }
+
+    void writeFrame(int startLine)
+    {
+      char name[512];
+      snprintf(name, sizeof(name), "%s/frame_%06lu.pbm", outDir.c_str(), stats.written);
+      FILE *out = fopen(name, "wb");
+      if (!out)
+      {
+        perror(name);
+        return;
+      }
+
+      // Baris layar y menampilkan baris buffer (y + startLine) mod tinggi panel
+      fprintf(out, "P4\n%d %d\n", width, height);
+      std::vector<uint8_t> line((width + 7) / 8);
+      for (int y = 0; y < height; y++)
+      {
+        int source = (y + startLine) % height;
+        std::fill(line.begin(), line.end(), 0);
+        for (int x = 0; x < width; x++)
+        {
+          if (frame[(source / 8) * width + x] & (1 << (source & 7)))
+            line[x / 8] |= 0x80 >> (x & 7);
+        }
+        fwrite(line.data(), 1, line.size(), out);
+      }
+      fclose(out);
+      stats.written++;
+    }
+  };
+}
+
+int main(int argc, char **argv)
+{
+  if (argc < 2)
+  {
+    fprintf(stderr, "usage: %s <stream|-> [output dir]\n", argv[0]);
+    return 1;
+  }
+
+  FILE *in = strcmp(argv[1], "-") == 0 ? stdin : fopen(argv[1], "rb");
+  if (!in)
+  {
+    perror(argv[1]);
+    return 1;
+  }
+
+  Decoder decoder(argc > 2 ? argv[2] : ".");
+  uint8_t chunk[4096];
+  size_t count;
+  while ((count = fread(chunk, 1, sizeof(chunk), in)) > 0)
+  {
+    decoder.feed(chunk, count);
+  }
+  if (in != stdin)
+    fclose(in);
+
+  const Stats &stats = decoder.getStats();
+  fprintf(stderr, "packets %lu (keyframes %lu), bad %lu, gaps %lu, frames written %lu\n",
+          stats.packets, stats.keyframes, stats.badPackets, stats.gaps, stats.written);
+  if (stats.packets > 0)
+  {
+    fprintf(stderr, "average payload %lu bytes/packet\n", stats.payloadBytes / stats.packets);
+  }
+  return 0;
+}